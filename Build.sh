@@ -0,0 +1,2 @@
+#!/bin/sh
+premake5 gmake2
\ No newline at end of file
@@ -23,8 +23,7 @@ project "ViBoard"
 	links {
 		"ImGui",
 		"SDL3",
-		"SDL3_image",
-		"opengl32"
+		"SDL3_image"
 	}
 
 	defines {
@@ -49,13 +48,13 @@ project "ViBoard"
 			"../dependencies/SDL3_image/vc/x86"
 		}
 
-	filter { "toolset:mingw or gcc", "platforms:x64" }
+	filter { "system:windows", "toolset:mingw or gcc", "platforms:x64" }
 		libdirs {
 			"../dependencies/SDL3/mingw/x64/lib",
 			"../dependencies/SDL3_image/mingw/x64/lib"
 		}
 
-	filter { "toolset:mingw or gcc", "platforms:x86" }
+	filter { "system:windows", "toolset:mingw or gcc", "platforms:x86" }
 		libdirs {
 			"../dependencies/SDL3/mingw/x86/lib",
 			"../dependencies/SDL3_image/mingw/x86/lib"
@@ -64,6 +63,11 @@ project "ViBoard"
 	filter "system:windows"
 		systemversion "latest"
 		defines { "VI_PLATFORM_WINDOWS" }
+		links { "opengl32" }
+
+	filter "system:linux"
+		defines { "VI_PLATFORM_LINUX" }
+		links { "GL", "pthread" }
 
 	filter "configurations:Debug"
 		kind "ConsoleApp"
@@ -19,6 +19,7 @@
 #include "Application.h"
 #include "appStates/MainState.h"
 #include "Exceptions.h"
+#include "FontCache.h"
 #include "platform/Platform.h"
 #include "ImGuiConfig.h"
 
@@ -62,14 +63,55 @@ namespace vi {
 
 		states.clear(); // Call state destructors while libraries are still initialized.
 
-		ImGui_ImplOpenGL3_Shutdown();
-		ImGui_ImplSDL3_Shutdown();
-		SDL_GL_DestroyContext(glContext);
-
+		if (guiInitialized) {
+			quitGui();
+		}
 		quitPlatform();
 	}
 
 	void Application::init() {
+		initPlatform();
+		if (!headless) {
+			loadIcons();
+		}
+
+		// Audio, hotkeys and the tray come up here. The window, GL context and fonts wait until the window is first shown.
+		states.emplace_back(std::make_unique<MainState>(*this));
+		if (!headless && !states.back()->startsHidden()) {
+			showWindow();
+		}
+	}
+
+	void Application::requestShow() noexcept {
+		showRequested = true;
+		wakeUpEventLoop();
+	}
+
+	void Application::showWindow() {
+		if (!guiInitialized) {
+			initGui();
+			states.back()->initGui();
+			SDL_ShowWindow(window.get());
+			return;
+		}
+		SDL_ShowWindow(window.get());
+		SDL_RestoreWindow(window.get());
+	}
+
+	void Application::loadIcons() noexcept {
+		icon.reset(IMG_Load("res/Icon.png"));
+		trayIcon.reset(IMG_Load("res/TrayIcon.png"));
+	}
+
+	void Application::initGui() {
+		IMGUI_CHECKVERSION();
+		ImGui::CreateContext();
+
+		ImGuiIO& io = ImGui::GetIO();
+		io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
+		io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+		io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+
 #if defined(IMGUI_IMPL_OPENGL_ES2)
 		// GL ES 2.0 + GLSL 100 (WebGL 1.0)
 		SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
@@ -100,8 +142,6 @@ namespace vi {
 		SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
 		SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
 
-		initPlatform();
-
 		window.reset(SDL_CreateWindow("ViBoard Beta", 1280, 720, SDL_WINDOW_RESIZABLE | SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN));
 		if (!window) {
 			throw ExternalError(SDL_GetError());
@@ -116,7 +156,6 @@ namespace vi {
 		ImGui_ImplOpenGL3_Init();
 
 		ImGuiStyle& style = ImGui::GetStyle();
-		ImGuiIO& io = ImGui::GetIO();
 		io.IniFilename = nullptr;
 		style.FrameRounding = 6.0f;
 		style.PopupRounding = 6.0f;
@@ -127,23 +166,60 @@ namespace vi {
 			style.Colors[ImGuiCol_WindowBg].w = 1.0f;
 		}
 
-		fonts.push_back(io.Fonts->AddFontFromFileTTF("res/fonts/Poppins-Regular.ttf", 19.0f));
-		fonts.push_back(io.Fonts->AddFontFromFileTTF("res/fonts/Poppins-SemiBold.ttf", 32.0f));
-		fonts.push_back(io.Fonts->AddFontFromFileTTF("res/fonts/Poppins-SemiBold.ttf", 46.0f));
-		fonts.push_back(io.Fonts->AddFontFromFileTTF("res/fonts/Poppins-Regular.ttf", 28.0f));
-		fonts.push_back(io.Fonts->AddFontFromFileTTF("res/fonts/Poppins-SemiBold.ttf", 21.0f));
-
-		states.emplace_back(std::make_unique<MainState>(*this));
+		static constexpr FontSpec fontSpecs[] = {
+			{"res/fonts/Poppins-Regular.ttf", 19.0f},
+			{"res/fonts/Poppins-SemiBold.ttf", 32.0f},
+			{"res/fonts/Poppins-SemiBold.ttf", 46.0f},
+			{"res/fonts/Poppins-Regular.ttf", 28.0f},
+			{"res/fonts/Poppins-SemiBold.ttf", 21.0f}
+		};
+		fonts = loadFonts(*io.Fonts, fontSpecs, SDL_GetWindowPixelDensity(window.get()), storagePath / "FontCache.bin");
+		// The renderer would convert the atlas to RGBA on its first frame. Done now, so the atlas is at its final size.
+		unsigned char* pixels = nullptr;
+		int width = 0;
+		int height = 0;
+		io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+		fontMemory.store(getAtlasMemory(*io.Fonts), std::memory_order_relaxed);
 
 		SDL_SetWindowIcon(window.get(), icon.get());
+		guiInitialized = true;
+	}
+
+	void Application::quitGui() noexcept {
+		ImGui_ImplOpenGL3_Shutdown();
+		ImGui_ImplSDL3_Shutdown();
+		SDL_GL_DestroyContext(glContext);
+		ImGui::DestroyContext();
+		window.reset();
+		fontMemory.store(0, std::memory_order_relaxed);
+		guiInitialized = false;
+	}
+
+	void Application::showError(const char* title, const std::string& message) const noexcept {
+		if (headless) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s %s", title, message.c_str());
+			return;
+		}
+		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, title, message.c_str(), window.get());
 	}
 
 	void Application::pollEvents() noexcept {
 		onPlatformEvent(*this);
 
+		if (showRequested.exchange(false)) {
+			try {
+				showWindow();
+			} catch (std::exception& e) {
+				showError("Unable to show window!", e.what());
+				quit();
+			}
+		}
+
 		SDL_Event event;
 		while (SDL_PollEvent(&event)) {
-			ImGui_ImplSDL3_ProcessEvent(&event);
+			if (guiInitialized) {
+				ImGui_ImplSDL3_ProcessEvent(&event);
+			}
 			states.back()->onEvent(event);
 
 			switch (event.type) {
@@ -26,6 +26,8 @@
 #include <imgui.h>
 
 #include <vector>
+#include <atomic>
+#include <string>
 #include <memory>
 #include <functional>
 #include <filesystem>
@@ -42,10 +44,17 @@ namespace vi {
 	public:
 		std::vector<std::unique_ptr<AppState>> states;
 		std::vector<ImFont*> fonts;
+		// See getAtlasMemory(). Worked out once the atlas is built, so it can be read from any thread. 0 while headless.
+		std::atomic<size_t> fontMemory = 0;
 
 		TrayOwner tray{nullptr, SDL_DestroyTray};
 		bool canSleep = true;
 
+		// A headless application has no window, GL context or ImGui. Only hotkeys, audio and the control socket run.
+		explicit Application(bool headless = false) noexcept
+			: headless(headless) {
+		}
+
 		void run();
 		
 		void quit() noexcept {
@@ -72,23 +81,41 @@ namespace vi {
 			return trayIcon.get();
 		}
 
+		bool isHeadless() const noexcept {
+			return headless;
+		}
+
+		// Also true until the window is first shown, as there is nothing to update or render before then.
 		bool isInactive() const noexcept {
-			return canSleep && (SDL_GetWindowFlags(window.get()) & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_HIDDEN) || inBackground);
+			return !guiInitialized || (canSleep && (SDL_GetWindowFlags(window.get()) & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_HIDDEN) || inBackground));
 		}
 
+		// Shows the window on the next event loop iteration, initializing the GUI first if needed. Thread-safe.
+		void requestShow() noexcept;
+
+		// Shows an error message box, or logs the error when running headless.
+		void showError(const char* title, const std::string& message) const noexcept;
+
 	private:
 		WindowOwner window{nullptr, SDL_DestroyWindow};
 		SDL_GLContext glContext = nullptr;
 		std::function<void()> menuBarCallback;
 
 		ImGuiID dockspaceId = 0;
-		SurfaceOwner icon{IMG_Load("res/Icon.png"), SDL_DestroySurface};
-		SurfaceOwner trayIcon{IMG_Load("res/TrayIcon.png"), SDL_DestroySurface};
+		SurfaceOwner icon{nullptr, SDL_DestroySurface};
+		SurfaceOwner trayIcon{nullptr, SDL_DestroySurface};
 
+		bool headless = false;
+		bool guiInitialized = false;
+		std::atomic<bool> showRequested = false;
 		bool running = false;
 		bool inBackground = false;
 
 		void init();
+		void initGui();
+		void quitGui() noexcept;
+		void loadIcons() noexcept;
+		void showWindow();
 
 		void pollEvents() noexcept;
 		void update();
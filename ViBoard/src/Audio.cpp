@@ -17,7 +17,9 @@
 */
 
 #include "Audio.h"
+#include "Hash.h"
 #include "Log.h"
+#include "platform/Platform.h"
 
 #ifdef VI_MSVC
 #pragma warning(push)
@@ -32,41 +34,323 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
 #include <utility>
 #include <tuple>
+#include <unordered_map>
 #include <stdlib.h>
 
 namespace fs = std::filesystem;
 
 namespace vi {
-	Sound::Sound(fs::path path) {
+	namespace {
+		// Whole pages for buffers outside of an arena, and at least one, so an empty sound still gets an allocation.
+		size_t getHeapCapacity(size_t size) noexcept {
+			return alignToPage(std::max<size_t>(size, 1));
+		}
+
+		// Size of len bytes of spec once converted to the mix format. Resampling may come out a frame off.
+		size_t estimateConvertedSize(const SDL_AudioSpec& spec, int len) noexcept {
+			const int frameSize = SDL_AUDIO_FRAMESIZE(spec);
+			if (frameSize <= 0 || spec.freq <= 0 || len <= 0) {
+				return 0;
+			}
+			const uint64_t frames = static_cast<uint64_t>(len) / frameSize;
+			const uint64_t converted = (frames * mixSpec.freq + spec.freq - 1) / spec.freq;
+			return static_cast<size_t>(converted * SDL_AUDIO_FRAMESIZE(mixSpec));
+		}
+	}
+
+	SampleBuffer::SampleBuffer(const SDL_AudioSpec& spec, const uint8_t* data, int len, PcmArena* arena) {
+		// Outside of an arena, the budget is reserved on an estimate before anything is copied or converted, so a sound
+		// that does not fit is turned down up front. The arena likewise checks the budget before adding a slab.
+		const size_t estimate = arena ? 0 : getHeapCapacity(estimateConvertedSize(spec, len));
+		if (!arena) {
+			reservePcm(estimate);
+		}
+
+		// Same as SDL_ConvertAudioSamples, but converts straight into page-aligned memory, so the buffer can be locked.
+		const AudioStreamOwner stream(SDL_CreateAudioStream(&spec, &mixSpec), SDL_DestroyAudioStream);
+		int available = -1;
+		if (stream && SDL_PutAudioStreamData(stream.get(), data, len) && SDL_FlushAudioStream(stream.get())) {
+			available = SDL_GetAudioStreamAvailable(stream.get());
+		}
+		try {
+			if (available < 0) {
+				throw ExternalError(SDL_GetError());
+			}
+			if (arena) {
+				allocate(*arena, static_cast<size_t>(available));
+			} else {
+				allocate(static_cast<size_t>(available), estimate);
+			}
+		} catch (...) {
+			if (!arena) {
+				releasePcm(estimate);
+			}
+			throw;
+		}
+
+		if (SDL_GetAudioStreamData(stream.get(), this->data, available) != available) {
+			deallocate();
+			throw ExternalError(SDL_GetError());
+		}
+		lock();
+	}
+
+	SampleBuffer::SampleBuffer(const SampleBuffer& other, PcmArena& arena)
+		: hash(other.hash) {
+		allocate(arena, other.size);
+		std::copy_n(other.data, other.size / sizeof(float), data);
+		lock();
+	}
+
+	SampleBuffer::~SampleBuffer() {
+		if (locked) {
+			unlockMemory(data, size);
+		}
+		deallocate();
+	}
+
+	void SampleBuffer::allocate(PcmArena& arena, size_t size) {
+		auto [block, slab] = arena.allocate(size);
+		data = static_cast<float*>(block);
+		this->size = size;
+		this->slab = std::move(slab);
+	}
+
+	void SampleBuffer::allocate(size_t size, size_t reserved) {
+		// Pages of its own, as locking works on whole pages. Unlocking a buffer would otherwise unpin its neighbours too.
+		const size_t capacity = getHeapCapacity(size);
+		if (capacity > reserved) {
+			reservePcm(capacity - reserved);
+		}
+		data = static_cast<float*>(SDL_aligned_alloc(getPageSize(), capacity));
+		if (!data) {
+			if (capacity > reserved) {
+				releasePcm(capacity - reserved);
+			}
+			throw ExternalError(SDL_GetError());
+		}
+		if (capacity < reserved) {
+			releasePcm(reserved - capacity);
+		}
+		this->size = size;
+	}
+
+	void SampleBuffer::deallocate() noexcept {
+		if (slab) {
+			slab->release(size);
+		} else {
+			SDL_aligned_free(data);
+			releasePcm(getHeapCapacity(size));
+		}
+	}
+
+	void SampleBuffer::lock() noexcept {
+		// Freshly written, so every page is already faulted in. Locking keeps it that way.
+		frames = static_cast<uint32_t>(size / SDL_AUDIO_FRAMESIZE(mixSpec));
+		locked = lockMemory(data, size);
+	}
+
+	namespace {
+		// Decoded samples by the hash of their file, so identical files are only decoded and held once.
+		class SampleCache {
+		public:
+			// Returns null if no samples from such a file are alive.
+			std::shared_ptr<const SampleBuffer> find(uint64_t hash, size_t fileSize, SDL_AudioSpec& spec) {
+				std::lock_guard lock(mutex);
+				const auto it = entries.find(hash);
+				if (it == entries.end() || it->second.fileSize != fileSize) {
+					return nullptr;
+				}
+				spec = it->second.spec;
+				return it->second.samples.lock();
+			}
+
+			std::shared_ptr<const SampleBuffer> find(const SampleBuffer& samples) {
+				std::lock_guard lock(mutex);
+				const auto it = entries.find(samples.getHash());
+				return it != entries.end() ? it->second.samples.lock() : nullptr;
+			}
+
+			void insert(const std::shared_ptr<const SampleBuffer>& samples, size_t fileSize, const SDL_AudioSpec& spec) {
+				std::lock_guard lock(mutex);
+				entries[samples->getHash()] = {samples, fileSize, spec};
+				prune();
+			}
+
+			// Points the entry at a moved copy of its samples.
+			void replace(const std::shared_ptr<const SampleBuffer>& samples) {
+				std::lock_guard lock(mutex);
+				if (const auto it = entries.find(samples->getHash()); it != entries.end()) {
+					it->second.samples = samples;
+				}
+			}
+
+		private:
+			struct Entry {
+				std::weak_ptr<const SampleBuffer> samples;
+				size_t fileSize = 0;
+				SDL_AudioSpec spec{};
+			};
+
+			std::mutex mutex;
+			std::unordered_map<uint64_t, Entry> entries;
+			size_t pruneAt = 64;
+
+			void prune() {
+				if (entries.size() < pruneAt) {
+					return;
+				}
+				std::erase_if(entries, [](const auto& entry) {
+					return entry.second.samples.expired();
+				});
+				pruneAt = std::max<size_t>(64, entries.size() * 2);
+			}
+		};
+
+		SampleCache& getSampleCache() {
+			static SampleCache cache;
+			return cache;
+		}
+
+		int64_t getModified(const fs::directory_entry& file) {
+			return static_cast<int64_t>(file.last_write_time().time_since_epoch().count());
+		}
+
+		std::shared_ptr<SampleBuffer> decodeMp3(const fs::path& path, const uint8_t* data, size_t size, SDL_AudioSpec& spec, PcmArena* arena) {
+			mp3dec_t mp3d;
+			mp3dec_file_info_t info;
+			if (mp3dec_load_buf(&mp3d, data, size, &info, NULL, NULL)) {
+				if (info.buffer) {
+					free(info.buffer);
+				}
+				throw IOError("Error loading " + path.string());
+			}
+
+			const std::unique_ptr<mp3d_sample_t, decltype(&free)> buffer(info.buffer, free);
+			spec = {SDL_AUDIO_S16, info.channels, info.hz};
+			return std::make_shared<SampleBuffer>(spec, reinterpret_cast<const uint8_t*>(buffer.get()), static_cast<int>(info.samples * sizeof(mp3d_sample_t)), arena);
+		}
+
+		std::shared_ptr<SampleBuffer> decodeWav(const uint8_t* data, size_t size, SDL_AudioSpec& spec, PcmArena* arena) {
+			uint8_t* samples = nullptr;
+			uint32_t len = 0;
+			if (!SDL_LoadWAV_IO(SDL_IOFromConstMem(data, size), true, &spec, &samples, &len)) {
+				throw IOError(SDL_GetError());
+			}
+			const std::unique_ptr<uint8_t, decltype(&SDL_free)> buffer(samples, SDL_free);
+			return std::make_shared<SampleBuffer>(spec, buffer.get(), static_cast<int>(len), arena);
+		}
+	}
+
+	bool SoundInfo::isCurrent(const fs::directory_entry& file) const {
+		return isKnown() && file.file_size() == size && getModified(file) == modified;
+	}
+
+	std::shared_ptr<const SampleBuffer> decodeSound(const fs::path& path, SoundInfo* info, PcmArena* arena) {
+		const fs::path ext = path.extension();
+		if (!isSupported(ext)) {
+			throw IOError("Unsupported file type: " + ext.string());
+		}
+
+		// Stamped before reading, so a write landing in between shows up as a change on the next scan.
+		const fs::directory_entry file(path);
+		const int64_t modified = getModified(file);
+
+		size_t size = 0;
+		const std::unique_ptr<uint8_t, decltype(&SDL_free)> data(static_cast<uint8_t*>(SDL_LoadFile(path.string().c_str(), &size)), SDL_free);
+		if (!data) {
+			throw IOError(SDL_GetError());
+		}
+
+		SDL_AudioSpec spec;
+		const uint64_t hash = hash64(data.get(), size);
+		std::shared_ptr<const SampleBuffer> samples = getSampleCache().find(hash, size, spec);
+		if (!samples) {
+			std::shared_ptr<SampleBuffer> decoded = ext == ".mp3" ? decodeMp3(path, data.get(), size, spec, arena) : decodeWav(data.get(), size, spec, arena);
+			decoded->setHash(hash);
+			samples = std::move(decoded);
+			getSampleCache().insert(samples, size, spec);
+		}
+
+		if (info) {
+			info->size = size;
+			info->modified = modified;
+			info->frames = samples->getFrames();
+			info->channels = static_cast<uint8_t>(spec.channels);
+			info->sampleRate = static_cast<uint32_t>(spec.freq);
+			info->hash = hash;
+		}
+		return samples;
+	}
+
+	void LazySamples::load() {
+		if (get()) {
+			return;
+		}
+		std::lock_guard lock(mutex);
+		if (!get()) {
+			samples.store(decodeSound(path, nullptr, arena.get()), std::memory_order_release);
+		}
+	}
+
+	void LazySamples::reload(const fs::path& path, SoundInfo& info) {
+		std::lock_guard lock(mutex);
+		samples.store(decodeSound(path, &info, arena.get()), std::memory_order_release);
+		this->path = path;
+	}
+
+	void LazySamples::compact() {
+		std::lock_guard lock(mutex);
+		const std::shared_ptr<const SampleBuffer> current = get();
+		if (!current) {
+			return;
+		}
+		if (std::shared_ptr<const SampleBuffer> shared = getSampleCache().find(*current); shared && shared != current) {
+			samples.store(std::move(shared), std::memory_order_release);
+			return;
+		}
+		if (arena && current->getSlab() && arena->shouldCompact(*current->getSlab())) {
+			auto moved = std::make_shared<const SampleBuffer>(*current, *arena);
+			getSampleCache().replace(moved);
+			samples.store(std::move(moved), std::memory_order_release);
+		}
+	}
+
+	Sound::Sound(fs::path path, std::shared_ptr<PcmArena> arena)
+		: samples(std::make_shared<LazySamples>(path, std::move(arena))) {
 		load(std::move(path));
 	}
 
+	Sound::Sound(fs::path path, const SoundInfo& info, std::shared_ptr<PcmArena> arena)
+		: path(std::move(path)),
+		info(info),
+		samples(std::make_shared<LazySamples>(this->path, std::move(arena))) {
+	}
+
 	Sound::Sound(Sound&& other) noexcept
 		: path(std::move(other.path)),
-		spec(other.spec),
-		buffer(other.buffer),
-		len(other.len),
-		deleter(other.deleter),
+		info(other.info),
+		samples(std::move(other.samples)),
 		hotkeyId(other.hotkeyId) {
 		
-		other.spec = {};
-		other.buffer = nullptr;
-		other.deleter = nullptr;
 		other.hotkeyId = nullHotkey;
 	}
 
 	Sound& Sound::operator=(Sound&& other) noexcept {
+		if (this == &other) {
+			return *this;
+		}
+		// Like destruction, assigning over a sound releases its hotkey.
+		if (isValidHotkey(hotkeyId)) {
+			unregisterHotkey(hotkeyId);
+		}
+
 		path = std::move(other.path);
-		
-		spec = other.spec;
-		other.spec = {};
-		buffer = other.buffer;
-		other.buffer = nullptr;
-		len = other.len;
-		deleter = other.deleter;
-		other.deleter = nullptr;
+		info = other.info;
+		samples = std::move(other.samples);
 
 		hotkeyId = other.hotkeyId;
 		other.hotkeyId = nullHotkey;
@@ -75,10 +359,6 @@ namespace vi {
 	}
 
 	Sound::~Sound() {
-		if (deleter) {
-			deleter(buffer);
-			buffer = nullptr;
-		}
 		try {
 			if (isValidHotkey(hotkeyId)) {
 				unregisterHotkey(hotkeyId);
@@ -90,57 +370,17 @@ namespace vi {
 	}
 
 	void Sound::load(fs::path path) {
-		const fs::path ext = path.extension();
-		if (ext == ".mp3") {
-			loadMp3(std::move(path));
-		} else if (ext == ".wav") {
-			loadWav(std::move(path));
-		} else {
-			throw IOError("Unsupported file type: " + ext.string());
+		if (!samples) {
+			samples = std::make_shared<LazySamples>(path);
 		}
-	}
-
-	void Sound::loadMp3(fs::path path) {
-		assert(path.extension() == ".mp3");
-		mp3dec_t mp3d;
-		mp3dec_file_info_t info;
-		if (mp3dec_load(&mp3d, path.string().c_str(), &info, NULL, NULL)) {
-			if (info.buffer) {
-				free(info.buffer);
-			}
-			throw IOError("Error loading " + path.string());
-		}
-
-		spec.freq = info.hz;
-		spec.channels = info.channels;
-		spec.format = SDL_AUDIO_S16;
-
-		buffer = reinterpret_cast<uint8_t*>(info.buffer);
-		len = static_cast<uint32_t>(info.samples * sizeof(mp3d_sample_t));
-
-		deleter = free;
-		this->path = std::move(path);
-	}
-
-	void Sound::loadWav(std::filesystem::path path) {
-		assert(path.extension() == ".wav");
-		if (!SDL_LoadWAV(path.string().c_str(), &spec, &buffer, &len)) {
-			throw IOError(SDL_GetError());
-		}
-		deleter = SDL_free;
+		samples->reload(path, info);
 		this->path = std::move(path);
 	}
 
-	void Sound::play(SDL_AudioStream* stream, size_t gainIndex) const {
-		SDL_ClearAudioStream(stream);
-		SDL_SetAudioStreamFormat(stream, &spec, nullptr);
-
-		if (gains[gainIndex].use) {
-			SDL_SetAudioStreamGain(stream, gains[gainIndex].gain);
-		}
-		if (!SDL_PutAudioStreamData(stream, buffer, len) || !SDL_ResumeAudioStreamDevice(stream)) {
-			throw ExternalError(SDL_GetError());
-		}
+	void Sound::assignFile(Sound&& other) noexcept {
+		path = std::move(other.path);
+		info = other.info;
+		samples = std::move(other.samples);
 	}
 
 	void from_json(const nlohmann::json& json, GainOverride& gain) {
@@ -18,8 +18,9 @@
 
 #pragma once
 
-#include "platform/HotKey.h"
+#include "platform/Hotkey.h"
 #include "Exceptions.h"
+#include "PcmArena.h"
 
 #include <SDL3/SDL.h>
 
@@ -28,20 +29,148 @@
 #include <filesystem>
 #include <memory>
 #include <array>
+#include <atomic>
+#include <mutex>
 #include <assert.h>
 
 namespace vi {
 	using AudioStreamOwner = std::unique_ptr<SDL_AudioStream, decltype(&SDL_DestroyAudioStream)>;
 
+	// Format every sound gets converted to on load, and the format mixers feed to their devices.
+	inline constexpr SDL_AudioSpec mixSpec{SDL_AUDIO_F32, 2, 48000};
+
 	struct GainOverride {
 		float gain = 1.0f;
 		bool use = false;
 	};
 
+	// One per output.
+	using SoundGains = std::array<GainOverride, 2>;
+
+	// Decoded PCM in mixSpec format. Its pages stay locked in memory for as long as it lives,
+	// so the audio thread never page faults on a sound that has been swapped out.
+	class SampleBuffer {
+	public:
+		// Placed in the arena if one is given, otherwise in pages of its own.
+		SampleBuffer(const SDL_AudioSpec& spec, const uint8_t* data, int len, PcmArena* arena = nullptr);
+		// Copies another buffer into the arena, for compaction.
+		SampleBuffer(const SampleBuffer& other, PcmArena& arena);
+
+		SampleBuffer(const SampleBuffer&) = delete;
+		SampleBuffer& operator=(const SampleBuffer&) = delete;
+
+		~SampleBuffer();
+
+		const float* getData() const noexcept {
+			return data;
+		}
+
+		uint32_t getFrames() const noexcept {
+			return frames;
+		}
+
+		size_t getSize() const noexcept {
+			return size;
+		}
+
+		// Null if the buffer is on the heap.
+		const PcmSlab* getSlab() const noexcept {
+			return slab.get();
+		}
+
+		// hash64 of the file the samples were decoded from, or 0 if they were not.
+		uint64_t getHash() const noexcept {
+			return hash;
+		}
+
+		void setHash(uint64_t hash) noexcept {
+			this->hash = hash;
+		}
+
+	private:
+		float* data = nullptr;
+		size_t size = 0;
+		uint32_t frames = 0;
+		bool locked = false;
+		std::shared_ptr<PcmSlab> slab;
+		uint64_t hash = 0;
+
+		void allocate(PcmArena& arena, size_t size);
+		// Outside of any arena. Takes over reserved bytes of budget and reserves or releases the difference.
+		// If it throws, the reservation is left as it was.
+		void allocate(size_t size, size_t reserved);
+		void deallocate() noexcept;
+		// Called once data has been written.
+		void lock() noexcept;
+	};
+
+	// What is known about a sound's file without decoding it. Saved with the settings as the board's manifest,
+	// so boards can be listed and their hotkeys registered on startup without touching the disk.
+	struct SoundInfo {
+		uint64_t size = 0;
+		// Last write time, in ticks of the file clock.
+		int64_t modified = 0;
+		// Length once converted to mixSpec.
+		uint32_t frames = 0;
+		// Format of the file itself.
+		uint8_t channels = 0;
+		uint32_t sampleRate = 0;
+		// hash64 of the file's contents.
+		uint64_t hash = 0;
+
+		// False until the file has been decoded at least once.
+		bool isKnown() const noexcept {
+			return sampleRate != 0;
+		}
+
+		// True if the file still has the size and last write time this info was taken from.
+		bool isCurrent(const std::filesystem::directory_entry& file) const;
+	};
+
+	// Decodes a file into mixSpec. If info is given, it is filled from the same read.
+	// Files with the same contents as one already decoded share its samples, wherever they are and whichever arena they are in.
+	std::shared_ptr<const SampleBuffer> decodeSound(const std::filesystem::path& path, SoundInfo* info = nullptr, PcmArena* arena = nullptr);
+
+	// Samples that get decoded on first use. Shared between a sound, whoever loads it and whoever plays it,
+	// so decoding can run on another thread while the sound is moved or even removed.
+	class LazySamples {
+	public:
+		// Samples are decoded into the arena if one is given.
+		LazySamples(std::filesystem::path path, std::shared_ptr<PcmArena> arena = nullptr) noexcept
+			: path(std::move(path)),
+			arena(std::move(arena)) {
+		}
+
+		std::shared_ptr<const SampleBuffer> get() const noexcept {
+			return samples.load(std::memory_order_acquire);
+		}
+
+		// Decodes the file unless that has already been done. Concurrent callers wait for the first one.
+		void load();
+		// Decodes the file again, for when it has changed on disk or been replaced by another.
+		void reload(const std::filesystem::path& path, SoundInfo& info);
+		// Moves the samples out of a mostly released slab into the arena's current one, letting the old slab be freed.
+		// Voices still playing the old buffer keep it alive until they finish. Shared samples that another sound
+		// has already moved are picked up from there instead.
+		void compact();
+
+	private:
+		std::atomic<std::shared_ptr<const SampleBuffer>> samples;
+		std::mutex mutex;
+		// Guarded by the mutex.
+		std::filesystem::path path;
+		std::shared_ptr<PcmArena> arena;
+	};
+
+	// A sound's file and hotkey. How loud it plays on each output is kept by whoever plays it, next to its samples,
+	// so triggering a sound does not have to read any of this.
 	class Sound {
 	public:
 		Sound() = default;
-		Sound(std::filesystem::path path);
+		// Decodes the file straight away.
+		Sound(std::filesystem::path path, std::shared_ptr<PcmArena> arena = nullptr);
+		// Takes the file's info from a manifest. Nothing is read until the samples are needed.
+		Sound(std::filesystem::path path, const SoundInfo& info, std::shared_ptr<PcmArena> arena = nullptr);
 
 		Sound(const Sound&) = delete;
 		Sound& operator=(const Sound&) = delete;
@@ -51,24 +180,30 @@ namespace vi {
 
 		~Sound();
 
-		void load(std::filesystem::path path);		
-		void loadMp3(std::filesystem::path path);
-		void loadWav(std::filesystem::path path);
-
-		void play(SDL_AudioStream* stream, size_t gainIndex) const;
+		void load(std::filesystem::path path);
+		// Takes another sound's file, info and samples while keeping this one's hotkey,
+		// for when its file has been modified or renamed.
+		void assignFile(Sound&& other) noexcept;
 
 		const std::filesystem::path& getPath() const noexcept {
 			return path;
 		}
 
-		GainOverride getGainOverride(size_t index) const noexcept {
-			assert(index < gains.size());
-			return gains[index];
+		const SoundInfo& getInfo() const noexcept {
+			return info;
 		}
 
-		void setGainOverride(size_t index, GainOverride gain) noexcept {
-			assert(index < gains.size());
-			gains[index] = gain;
+		void setInfo(const SoundInfo& info) noexcept {
+			this->info = info;
+		}
+
+		// Null until loaded.
+		std::shared_ptr<const SampleBuffer> getSamples() const noexcept {
+			return samples ? samples->get() : nullptr;
+		}
+
+		const std::shared_ptr<LazySamples>& getLazySamples() const noexcept {
+			return samples;
 		}
 
 		const HotkeyId* getHotkeyId() const noexcept {
@@ -81,13 +216,9 @@ namespace vi {
 
 	private:
 		std::filesystem::path path;
-		
-		SDL_AudioSpec spec{};
-		uint8_t* buffer = nullptr;
-		uint32_t len = 0;
-		void(*deleter)(void* ptr) = nullptr;
-
-		std::array<GainOverride, 2> gains;
+		SoundInfo info;
+		// Buffers handed out by it are shared with any mixer voice still playing them, so the sound can be removed mid-playback.
+		std::shared_ptr<LazySamples> samples;
 		HotkeyId hotkeyId = nullHotkey;
 	};
 
@@ -0,0 +1,180 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "AudioEngine.h"
+#include "Exceptions.h"
+#include "platform/Platform.h"
+
+#include <assert.h>
+
+namespace vi {
+	AudioEngine::~AudioEngine() {
+		std::lock_guard lock(mutex);
+		setPushToTalkActive(false);
+	}
+
+	void AudioEngine::setOutput(size_t index, SDL_AudioDeviceID device, float gain) noexcept {
+		assert(index < outputs.size());
+		std::lock_guard lock(mutex);
+		Output& output = outputs[index];
+		output.device = device;
+		output.gain = gain;
+		output.mixer.setGain(gain);
+	}
+
+	void AudioEngine::setDualPlayback(bool dual) noexcept {
+		std::lock_guard lock(mutex);
+		dualPlayback = dual;
+	}
+
+	void AudioEngine::setGain(size_t index, float gain) noexcept {
+		assert(index < outputs.size());
+		std::lock_guard lock(mutex);
+		outputs[index].gain = gain;
+		outputs[index].mixer.setGain(gain);
+	}
+
+	float AudioEngine::getGain(size_t index) const noexcept {
+		assert(index < outputs.size());
+		std::lock_guard lock(mutex);
+		return outputs[index].gain;
+	}
+
+	void AudioEngine::setPushToTalkKey(SDL_Scancode scancode, uint16_t raw) noexcept {
+		std::lock_guard lock(mutex);
+		if (scancode != pttScancode || raw != pttRaw) {
+			setPushToTalkActive(false);
+			pttScancode = scancode;
+			pttRaw = raw;
+		}
+	}
+
+	void AudioEngine::setPushToTalkEnabled(bool enabled) noexcept {
+		std::lock_guard lock(mutex);
+		usePtt = enabled;
+		if (!usePtt) {
+			setPushToTalkActive(false);
+		}
+	}
+
+	void AudioEngine::togglePushToTalk() noexcept {
+		std::lock_guard lock(mutex);
+		usePtt = !usePtt;
+		if (!usePtt) {
+			setPushToTalkActive(false);
+		}
+	}
+
+	bool AudioEngine::isPushToTalkEnabled() const noexcept {
+		std::lock_guard lock(mutex);
+		return usePtt;
+	}
+
+	void AudioEngine::setPushToTalkTiming(uint32_t preRoll, uint32_t tail) noexcept {
+		std::lock_guard lock(mutex);
+		pttPreRollFrames = static_cast<uint32_t>(static_cast<uint64_t>(preRoll) * mixSpec.freq / 1000);
+		pttTailFrames = static_cast<uint32_t>(static_cast<uint64_t>(tail) * mixSpec.freq / 1000);
+	}
+
+	void AudioEngine::play(LazySamples& samples, const SoundGains& gains, Uint64 triggerTime) {
+		// Only decodes if the loader has not got to this sound yet. Done before locking the engine, so it can be stopped meanwhile.
+		samples.load();
+		const std::shared_ptr<const SampleBuffer> buffer = samples.get();
+
+		std::lock_guard lock(mutex);
+		if (outputs[0].device == 0) {
+			throw ExternalError("No output device selected.");
+		}
+
+		// The pre-roll is only needed when the key is not held down yet.
+		const bool ptt = usePtt && pttScancode != SDL_SCANCODE_UNKNOWN;
+		const uint32_t delay = ptt && !pttActive ? pttPreRollFrames : 0;
+
+		const bool playDual = dualPlayback && outputs[1].device != 0 && outputs[0].device != outputs[1].device;
+		for (size_t i = 0; i < (playDual ? 2 : 1); i++) {
+			Output& output = outputs[i];
+			output.mixer.open(output.device);
+			output.mixer.setTail(ptt ? pttTailFrames : 0);
+			output.mixer.replace(buffer, gains[i], triggerTime, delay);
+		}
+		setPushToTalkActive(usePtt);
+	}
+
+	void AudioEngine::stop() noexcept {
+		std::lock_guard lock(mutex);
+		for (Output& output : outputs) {
+			output.mixer.stop();
+			output.mixer.pauseIfIdle();
+		}
+		setPushToTalkActive(false);
+	}
+
+	bool AudioEngine::isPlaying() const noexcept {
+		std::lock_guard lock(mutex);
+		return isPlayingLocked();
+	}
+
+	Uint64 AudioEngine::getLatency() const noexcept {
+		return outputs[0].mixer.getLatency();
+	}
+
+	uint32_t AudioEngine::getLatencyFrames() const noexcept {
+		return outputs[0].mixer.getLatencyFrames();
+	}
+
+	Mixer::Stats AudioEngine::getStats(size_t index) const noexcept {
+		assert(index < outputs.size());
+		std::lock_guard lock(mutex);
+		return outputs[index].mixer.getStats();
+	}
+
+	void AudioEngine::resetStats() noexcept {
+		std::lock_guard lock(mutex);
+		for (Output& output : outputs) {
+			output.mixer.resetStats();
+		}
+	}
+
+	void AudioEngine::onPlaybackFinished() noexcept {
+		std::lock_guard lock(mutex);
+		for (Output& output : outputs) {
+			output.mixer.pauseIfIdle();
+		}
+		if (!isPlayingLocked()) {
+			setPushToTalkActive(false);
+		}
+	}
+
+	bool AudioEngine::isPlayingLocked() const noexcept {
+		for (const Output& output : outputs) {
+			if (output.mixer.isPlaying()) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void AudioEngine::setPushToTalkActive(bool active) noexcept {
+		// Only sent on transitions. The key is held down by the OS until released.
+		if (active == pttActive || (active && pttScancode == SDL_SCANCODE_UNKNOWN)) {
+			return;
+		}
+		sendKeyPress(pttScancode, pttRaw, active);
+		pttActive = active;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Audio.h"
+#include "Mixer.h"
+
+#include <SDL3/SDL.h>
+
+#include <array>
+#include <mutex>
+
+namespace vi {
+	// Owns every output and the push-to-talk key. All member functions are thread-safe, so sounds
+	// can be triggered from the hotkey thread without going through the UI.
+	class AudioEngine {
+	public:
+		static constexpr size_t outputCount = 2;
+		static_assert(std::tuple_size_v<SoundGains> == outputCount);
+
+		AudioEngine() = default;
+
+		AudioEngine(const AudioEngine&) = delete;
+		AudioEngine& operator=(const AudioEngine&) = delete;
+
+		~AudioEngine();
+
+		// A device of 0 means the output is unassigned.
+		void setOutput(size_t index, SDL_AudioDeviceID device, float gain) noexcept;
+		void setDualPlayback(bool dual) noexcept;
+		void setGain(size_t index, float gain) noexcept;
+		float getGain(size_t index) const noexcept;
+
+		void setPushToTalkKey(SDL_Scancode scancode, uint16_t raw) noexcept;
+		void setPushToTalkEnabled(bool enabled) noexcept;
+		void togglePushToTalk() noexcept;
+		bool isPushToTalkEnabled() const noexcept;
+		// While push-to-talk is in use, sounds start preRoll ms after the key goes down,
+		// and the key is held for tail ms after the last sound ends. Both are timed on the audio device.
+		void setPushToTalkTiming(uint32_t preRoll, uint32_t tail) noexcept;
+
+		// See Mixer::play() for triggerTime. Decodes the samples first if they have not been loaded yet.
+		void play(LazySamples& samples, const SoundGains& gains, Uint64 triggerTime = 0);
+		void stop() noexcept;
+		bool isPlaying() const noexcept;
+		// Latency of the most recent measured trigger on the primary output, in nanoseconds. 0 if none yet.
+		Uint64 getLatency() const noexcept;
+		// See Mixer::getLatencyFrames(). Also for the primary output.
+		uint32_t getLatencyFrames() const noexcept;
+		// See Mixer::Stats. Outputs that have not played anything yet report nothing.
+		Mixer::Stats getStats(size_t index) const noexcept;
+		void resetStats() noexcept;
+
+		// Should be called on every playback event. Pauses idle devices and releases push-to-talk.
+		void onPlaybackFinished() noexcept;
+
+	private:
+		struct Output {
+			Mixer mixer;
+			SDL_AudioDeviceID device = 0;
+			float gain = 1.0f;
+		};
+
+		mutable std::mutex mutex;
+		std::array<Output, outputCount> outputs;
+		bool dualPlayback = false;
+
+		SDL_Scancode pttScancode = SDL_SCANCODE_UNKNOWN;
+		uint16_t pttRaw = 0;
+		bool usePtt = false;
+		bool pttActive = false;
+		uint32_t pttPreRollFrames = 0;
+		uint32_t pttTailFrames = 0;
+
+		bool isPlayingLocked() const noexcept;
+		void setPushToTalkActive(bool active) noexcept;
+	};
+}
\ No newline at end of file
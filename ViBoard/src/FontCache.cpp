@@ -0,0 +1,241 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "FontCache.h"
+#include "Hash.h"
+#include "Log.h"
+
+#include <SDL3/SDL.h>
+
+#include <fstream>
+#include <string.h>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	namespace {
+		constexpr uint32_t cacheMagic = 0x43464956; // "VIFC"
+		constexpr uint32_t cacheVersion = 1;
+		constexpr int maxTextureSize = 16384;
+		constexpr uint32_t maxGlyphs = 0x10000;
+		constexpr int lineCount = IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1;
+
+		struct FontHeader {
+			float size;
+			float ascent;
+			float descent;
+			uint32_t fallbackChar;
+			uint32_t ellipsisChar;
+			uint32_t glyphCount;
+		};
+
+		template<typename T>
+		bool read(std::istream& stream, T& value) {
+			return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+		}
+
+		template<typename T>
+		void write(std::ostream& stream, const T& value) {
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		// Returns 0 if a font file can't be read. Nothing is cached then, and ImGui reports the missing font as usual.
+		uint64_t getCacheKey(std::span<const FontSpec> specs, float density) noexcept {
+			uint64_t key = hashValue(cacheVersion);
+			// The glyph table is stored as ImGui lays it out.
+			key = hashValue(IMGUI_VERSION_NUM, key);
+			key = hashValue(sizeof(ImFontGlyph), key);
+			key = hashValue(density, key);
+
+			for (const FontSpec& spec : specs) {
+				size_t size = 0;
+				void* data = SDL_LoadFile(spec.path, &size);
+				if (!data) {
+					return 0;
+				}
+				key = hash64(data, size, key);
+				SDL_free(data);
+				key = hashValue(spec.size, key);
+			}
+			return key;
+		}
+
+		bool readCache(ImFontAtlas& atlas, const fs::path& path, uint64_t key, size_t fontCount, float density) {
+			std::ifstream stream(path, std::ios::binary);
+
+			uint32_t magic = 0;
+			uint32_t version = 0;
+			uint64_t fileKey = 0;
+			if (!read(stream, magic) || !read(stream, version) || !read(stream, fileKey)
+				|| magic != cacheMagic || version != cacheVersion || fileKey != key) {
+				return false;
+			}
+
+			int width = 0;
+			int height = 0;
+			ImVec2 uvScale;
+			ImVec2 uvWhitePixel;
+			ImVec4 uvLines[lineCount];
+			uint32_t count = 0;
+			if (!read(stream, width) || !read(stream, height) || !read(stream, uvScale) || !read(stream, uvWhitePixel)
+				|| !read(stream, uvLines) || !read(stream, count)) {
+				return false;
+			}
+			if (width <= 0 || height <= 0 || width > maxTextureSize || height > maxTextureSize || count != fontCount) {
+				return false;
+			}
+
+			// Everything is read up front, so a truncated file leaves the atlas untouched.
+			std::vector<FontHeader> headers(count);
+			std::vector<std::vector<ImFontGlyph>> glyphs(count);
+			for (uint32_t i = 0; i < count; i++) {
+				if (!read(stream, headers[i]) || headers[i].glyphCount > maxGlyphs) {
+					return false;
+				}
+				glyphs[i].resize(headers[i].glyphCount);
+				stream.read(reinterpret_cast<char*>(glyphs[i].data()), glyphs[i].size() * sizeof(ImFontGlyph));
+			}
+			std::vector<unsigned char> pixels(static_cast<size_t>(width) * height);
+			stream.read(reinterpret_cast<char*>(pixels.data()), pixels.size());
+			if (!stream) {
+				return false;
+			}
+
+			atlas.Clear();
+			// Fonts point into ConfigData, so it must not grow once they exist.
+			for (const FontHeader& header : headers) {
+				ImFontConfig config;
+				config.FontDataOwnedByAtlas = false;
+				config.SizePixels = header.size;
+				config.RasterizerDensity = density;
+				config.EllipsisChar = static_cast<ImWchar>(header.ellipsisChar);
+				atlas.ConfigData.push_back(config);
+			}
+			for (uint32_t i = 0; i < count; i++) {
+				ImFont* font = IM_NEW(ImFont)();
+				font->ContainerAtlas = &atlas;
+				font->ConfigData = &atlas.ConfigData[i];
+				font->ConfigDataCount = 1;
+				font->FontSize = headers[i].size;
+				font->Ascent = headers[i].ascent;
+				font->Descent = headers[i].descent;
+				font->FallbackChar = static_cast<ImWchar>(headers[i].fallbackChar);
+				font->EllipsisChar = static_cast<ImWchar>(headers[i].ellipsisChar);
+				font->Glyphs.resize(static_cast<int>(glyphs[i].size()));
+				memcpy(font->Glyphs.Data, glyphs[i].data(), glyphs[i].size() * sizeof(ImFontGlyph));
+				font->BuildLookupTable();
+
+				atlas.ConfigData[i].DstFont = font;
+				atlas.Fonts.push_back(font);
+			}
+
+			// The atlas frees its texture data with IM_FREE.
+			atlas.TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(pixels.size()));
+			memcpy(atlas.TexPixelsAlpha8, pixels.data(), pixels.size());
+			atlas.TexWidth = width;
+			atlas.TexHeight = height;
+			atlas.TexUvScale = uvScale;
+			atlas.TexUvWhitePixel = uvWhitePixel;
+			for (int i = 0; i < lineCount; i++) {
+				atlas.TexUvLines[i] = uvLines[i];
+			}
+			atlas.TexReady = true;
+			return true;
+		}
+
+		void writeCache(ImFontAtlas& atlas, const fs::path& path, uint64_t key) noexcept {
+			if (atlas.TexPixelsUseColors) {
+				return; // Colored glyphs don't fit in an alpha only texture.
+			}
+
+			unsigned char* pixels = nullptr;
+			int width = 0;
+			int height = 0;
+			atlas.GetTexDataAsAlpha8(&pixels, &width, &height);
+			if (!pixels) {
+				return;
+			}
+
+			std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+			write(stream, cacheMagic);
+			write(stream, cacheVersion);
+			write(stream, key);
+			write(stream, width);
+			write(stream, height);
+			write(stream, atlas.TexUvScale);
+			write(stream, atlas.TexUvWhitePixel);
+			write(stream, atlas.TexUvLines);
+			write(stream, static_cast<uint32_t>(atlas.Fonts.Size));
+
+			for (const ImFont* font : atlas.Fonts) {
+				const FontHeader header{
+					font->FontSize,
+					font->Ascent,
+					font->Descent,
+					font->FallbackChar,
+					font->EllipsisChar,
+					static_cast<uint32_t>(font->Glyphs.Size)
+				};
+				write(stream, header);
+				stream.write(reinterpret_cast<const char*>(font->Glyphs.Data), font->Glyphs.Size * sizeof(ImFontGlyph));
+			}
+			stream.write(reinterpret_cast<const char*>(pixels), static_cast<std::streamsize>(width) * height);
+
+			if (!stream) {
+				VI_WARN("Unable to write font cache to %s", path.string().c_str());
+				stream.close();
+				std::error_code error;
+				fs::remove(path, error);
+			}
+		}
+	}
+
+	std::vector<ImFont*> loadFonts(ImFontAtlas& atlas, std::span<const FontSpec> specs, float density, const fs::path& cachePath) {
+		const uint64_t key = getCacheKey(specs, density);
+		if (key != 0 && readCache(atlas, cachePath, key, specs.size(), density)) {
+			VI_DEBUG("Loaded font atlas from %s", cachePath.string().c_str());
+			return std::vector<ImFont*>(atlas.Fonts.begin(), atlas.Fonts.end());
+		}
+
+		std::vector<ImFont*> fonts;
+		fonts.reserve(specs.size());
+		for (const FontSpec& spec : specs) {
+			ImFontConfig config;
+			config.RasterizerDensity = density;
+			fonts.push_back(atlas.AddFontFromFileTTF(spec.path, spec.size, &config));
+		}
+		atlas.Build();
+
+		if (key != 0) {
+			writeCache(atlas, cachePath, key);
+		}
+		return fonts;
+	}
+
+	size_t getAtlasMemory(const ImFontAtlas& atlas) noexcept {
+		const size_t pixels = static_cast<size_t>(atlas.TexWidth) * atlas.TexHeight;
+		size_t size = pixels * 4;
+		if (atlas.TexPixelsAlpha8) {
+			size += pixels;
+		}
+		if (atlas.TexPixelsRGBA32) {
+			size += pixels * 4;
+		}
+		return size;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <imgui.h>
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace vi {
+	struct FontSpec {
+		const char* path;
+		float size;
+	};
+
+	// Adds the fonts to the atlas and builds it. A built atlas is kept in cachePath, keyed by the font files' contents,
+	// sizes and rasterizer density, so glyphs are only rasterized again when one of those changes.
+	// Returns the fonts in the order given.
+	std::vector<ImFont*> loadFonts(ImFontAtlas& atlas, std::span<const FontSpec> specs, float density, const std::filesystem::path& cachePath);
+
+	// Bytes of pixels the atlas keeps, plus its texture, which renderers upload as 4 bytes per pixel.
+	size_t getAtlasMemory(const ImFontAtlas& atlas) noexcept;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Hash.h"
+
+#include <string.h>
+
+namespace vi {
+	namespace {
+		constexpr uint64_t prime1 = 11400714785074694791ull;
+		constexpr uint64_t prime2 = 14029467366897019727ull;
+		constexpr uint64_t prime3 = 1609587929392839161ull;
+		constexpr uint64_t prime4 = 9650029242287828579ull;
+		constexpr uint64_t prime5 = 2870177450012600261ull;
+
+		constexpr uint64_t rotateLeft(uint64_t x, int bits) noexcept {
+			return (x << bits) | (x >> (64 - bits));
+		}
+
+		// Inputs are read as little endian, which is what every supported platform is.
+		inline uint64_t read64(const unsigned char* p) noexcept {
+			uint64_t value;
+			memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+		inline uint32_t read32(const unsigned char* p) noexcept {
+			uint32_t value;
+			memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+		constexpr uint64_t round(uint64_t acc, uint64_t input) noexcept {
+			acc += input * prime2;
+			acc = rotateLeft(acc, 31);
+			return acc * prime1;
+		}
+
+		constexpr uint64_t mergeRound(uint64_t acc, uint64_t value) noexcept {
+			acc ^= round(0, value);
+			return acc * prime1 + prime4;
+		}
+	}
+
+	uint64_t hash64(const void* data, size_t size, uint64_t seed) noexcept {
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		const unsigned char* const end = p + size;
+		uint64_t h;
+
+		if (size >= 32) {
+			uint64_t v1 = seed + prime1 + prime2;
+			uint64_t v2 = seed + prime2;
+			uint64_t v3 = seed;
+			uint64_t v4 = seed - prime1;
+			for (const unsigned char* limit = end - 32; p <= limit; p += 32) {
+				v1 = round(v1, read64(p));
+				v2 = round(v2, read64(p + 8));
+				v3 = round(v3, read64(p + 16));
+				v4 = round(v4, read64(p + 24));
+			}
+			h = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+			h = mergeRound(h, v1);
+			h = mergeRound(h, v2);
+			h = mergeRound(h, v3);
+			h = mergeRound(h, v4);
+		} else {
+			h = seed + prime5;
+		}
+		h += size;
+
+		for (; p + 8 <= end; p += 8) {
+			h ^= round(0, read64(p));
+			h = rotateLeft(h, 27) * prime1 + prime4;
+		}
+		if (p + 4 <= end) {
+			h ^= read32(p) * prime1;
+			h = rotateLeft(h, 23) * prime2 + prime3;
+			p += 4;
+		}
+		for (; p < end; p++) {
+			h ^= *p * prime5;
+			h = rotateLeft(h, 11) * prime1;
+		}
+
+		h ^= h >> 33;
+		h *= prime2;
+		h ^= h >> 29;
+		h *= prime3;
+		h ^= h >> 32;
+		return h;
+	}
+}
\ No newline at end of file
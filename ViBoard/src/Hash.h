@@ -0,0 +1,36 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <type_traits>
+
+namespace vi {
+	// XXH64 of the given bytes. The result is stable across runs and platforms, so it can key data on disk.
+	uint64_t hash64(const void* data, size_t size, uint64_t seed = 0) noexcept;
+
+	// Hashes the object representation, so padding must not be left uninitialized.
+	template<typename T>
+	uint64_t hashValue(const T& value, uint64_t seed = 0) noexcept {
+		static_assert(std::is_trivially_copyable_v<T>);
+		return hash64(&value, sizeof(value), seed);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <stdint.h>
+
+namespace vi {
+	// Counts values into power of two buckets without locking, so the audio thread can record into it.
+	// Bucket 0 counts zeros and bucket i counts values below 2^i, with the last one also taking anything larger.
+	class Histogram {
+	public:
+		static constexpr size_t bucketCount = 20;
+		using Counts = std::array<uint64_t, bucketCount>;
+
+		void add(uint64_t value) noexcept {
+			const size_t bucket = std::min<size_t>(std::bit_width(value), bucketCount - 1);
+			buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		Counts getCounts() const noexcept {
+			Counts counts;
+			for (size_t i = 0; i < bucketCount; i++) {
+				counts[i] = buckets[i].load(std::memory_order_relaxed);
+			}
+			return counts;
+		}
+
+		void reset() noexcept {
+			for (std::atomic<uint64_t>& bucket : buckets) {
+				bucket.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		// The bound that at least the given fraction of values, such as 0.99, are below. 0 if nothing was recorded.
+		static uint64_t getPercentile(const Counts& counts, double fraction) noexcept {
+			uint64_t total = 0;
+			for (const uint64_t count : counts) {
+				total += count;
+			}
+			uint64_t seen = 0;
+			for (size_t i = 0; i < bucketCount; i++) {
+				seen += counts[i];
+				if (seen > 0 && static_cast<double>(seen) >= fraction * static_cast<double>(total)) {
+					return uint64_t(1) << i;
+				}
+			}
+			return 0;
+		}
+
+	private:
+		std::array<std::atomic<uint64_t>, bucketCount> buckets{};
+	};
+}
\ No newline at end of file
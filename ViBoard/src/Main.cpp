@@ -19,38 +19,33 @@
 #include "Exceptions.h"
 #include "Log.h"
 #include "Application.h"
-
-#include <imgui.h>
+#include "platform/ControlSocket.h"
 
 #include <SDL3/SDL.h>
 
 #include <string>
+#include <string_view>
 #include <exception>
 #include <fstream>
+#include <format>
 #include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
 
 using namespace std::string_literals;
 
 namespace vi {
 	namespace {
-		void init() {
+		void init(bool headless) {
 			SDL_SetLogPriorities(SDL_LOG_PRIORITY_INFO);
-			if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO)) {
+			const SDL_InitFlags flags = headless ? SDL_INIT_AUDIO | SDL_INIT_EVENTS : SDL_INIT_VIDEO | SDL_INIT_AUDIO;
+			if (!SDL_Init(flags)) {
 				throw ExternalError("Failed to initialize SDL: "s + SDL_GetError());
 			}
-
-			IMGUI_CHECKVERSION();
-			ImGui::CreateContext();
-
-			ImGuiIO& io = ImGui::GetIO();
-			io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
-			io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
-			io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
 		}
 
 		void quit() noexcept {
 			SDL_Quit();
-			ImGui::DestroyContext();
 		}
 
 		void onError(const char* error) noexcept {
@@ -64,10 +59,52 @@ namespace vi {
 
 			SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "FATAL CRASH!", message.c_str(), nullptr);
 		}
+
+		// Translates command-line arguments into control socket commands. Returns false on unknown arguments.
+		bool toControlCommands(int argc, char** argv, std::string& commands) {
+			for (int i = 1; i < argc; i++) {
+				const std::string_view arg = argv[i];
+				if (arg == "--play" && i + 1 < argc) {
+					commands += std::format("play {}\n", argv[i + 1]);
+					i++;
+				} else if (arg == "--stop") {
+					commands += "stop\n";
+				} else if (arg == "--gain" && i + 2 < argc) {
+					commands += std::format("gain {} {}\n", argv[i + 1], argv[i + 2]);
+					i += 2;
+				} else {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Runs before anything is initialized, so the running instance gets the commands as fast as possible.
+		int forwardCommands(int argc, char** argv) {
+			std::string commands;
+			if (!toControlCommands(argc, argv, commands)) {
+				fputs("Usage: ViBoard [--headless]\n"
+					"       ViBoard [--play <board>/<sound>] [--stop] [--gain <output> <gain>]\n", stderr);
+				return EXIT_FAILURE;
+			}
+
+			std::string reply;
+			if (!sendControlCommands(commands, reply)) {
+				fputs("ViBoard is not running.\n", stderr);
+				return EXIT_FAILURE;
+			}
+			fputs(reply.c_str(), stdout);
+			return reply.starts_with("err") || reply.find("\nerr") != std::string::npos ? EXIT_FAILURE : EXIT_SUCCESS;
+		}
 	}
 }
 
-int main() {
+int main(int argc, char** argv) {
+	const bool headless = argc == 2 && std::string_view(argv[1]) == "--headless";
+	if (argc > 1 && !headless) {
+		return vi::forwardCommands(argc, argv);
+	}
+
 	static const auto instancePath = vi::storagePath / "ViBoard.instance";
 	std::error_code ec;
 	if (std::filesystem::exists(instancePath) && !std::filesystem::remove(instancePath, ec)) {
@@ -80,9 +117,9 @@ int main() {
 
 	int exit = EXIT_FAILURE;
 	try {
-		vi::init();
+		vi::init(headless);
 
-		vi::Application app;
+		vi::Application app(headless);
 		app.run();
 		exit = EXIT_SUCCESS;
 
@@ -0,0 +1,417 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Mixer.h"
+#include "Log.h"
+#include "platform/Platform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <semaphore>
+#include <thread>
+#include <assert.h>
+
+namespace vi {
+	namespace {
+		class StreamLock {
+		public:
+			StreamLock(SDL_AudioStream* stream) noexcept
+				: stream(stream) {
+				SDL_LockAudioStream(stream);
+			}
+
+			StreamLock(const StreamLock&) = delete;
+			StreamLock& operator=(const StreamLock&) = delete;
+
+			~StreamLock() {
+				SDL_UnlockAudioStream(stream);
+			}
+
+		private:
+			SDL_AudioStream* stream;
+		};
+
+		// Pushes playback events on behalf of the audio threads, as pushing an event locks and may allocate.
+		// Audio threads only set a flag and release a semaphore, neither of which does.
+		class IdleNotifier {
+		public:
+			IdleNotifier()
+				: thread([this]() {
+					run();
+				}) {
+				// Touched by the audio threads. Never unlocked, as it lives until exit.
+				lockMemory(this, sizeof(*this));
+			}
+
+			IdleNotifier(const IdleNotifier&) = delete;
+			IdleNotifier& operator=(const IdleNotifier&) = delete;
+
+			~IdleNotifier() {
+				quitting.store(true, std::memory_order_relaxed);
+				signal.release();
+				thread.join();
+			}
+
+			void notify() noexcept {
+				// Only released while nothing is pending, so the semaphore never goes past 1.
+				if (!pending.exchange(true, std::memory_order_acq_rel)) {
+					signal.release();
+				}
+			}
+
+		private:
+			std::binary_semaphore signal{0};
+			std::atomic<bool> pending = false;
+			std::atomic<bool> quitting = false;
+			std::thread thread;
+
+			void run() noexcept {
+				while (true) {
+					signal.acquire();
+					if (quitting.load(std::memory_order_relaxed)) {
+						return;
+					}
+					pending.store(false, std::memory_order_release);
+
+					SDL_Event event{};
+					event.user.type = getPlaybackEventType();
+					SDL_PushEvent(&event);
+					wakeUpEventLoop();
+				}
+			}
+		};
+
+		IdleNotifier& getIdleNotifier() {
+			static IdleNotifier notifier;
+			return notifier;
+		}
+	}
+
+	Uint32 getPlaybackEventType() noexcept {
+		static const Uint32 type = SDL_RegisterEvents(1);
+		return type;
+	}
+
+	Mixer::Mixer() {
+		const size_t page = getPageSize();
+		const size_t size = (sizeof(State) + page - 1) / page * page;
+		void* memory = SDL_aligned_alloc(std::max(page, alignof(State)), size);
+		if (!memory) {
+			throw ExternalError(SDL_GetError());
+		}
+		state.reset(new (memory) State());
+	}
+
+	Mixer::~Mixer() {
+		close();
+		if (locked) {
+			unlockMemory(state.get(), sizeof(State));
+		}
+	}
+
+	void Mixer::StateDeleter::operator()(State* state) const noexcept {
+		state->~State();
+		SDL_aligned_free(state);
+	}
+
+	void Mixer::open(SDL_AudioDeviceID device) {
+		if (stream && this->device == device) {
+			return;
+		}
+		close();
+		resetStats();
+
+		if (!locked) {
+			locked = lockMemory(state.get(), sizeof(State));
+		}
+		// Started here rather than on first use by the audio thread.
+		getIdleNotifier();
+
+		stream.reset(SDL_OpenAudioDeviceStream(device, &mixSpec, onAudio, state.get()));
+		if (!stream) {
+			throw ExternalError(SDL_GetError());
+		}
+		this->device = device;
+		paused = true;
+
+		SDL_AudioSpec spec;
+		int frames = 0;
+		if (SDL_GetAudioDeviceFormat(device, &spec, &frames) && spec.freq > 0) {
+			deviceFrames = static_cast<uint32_t>(static_cast<int64_t>(frames) * mixSpec.freq / spec.freq);
+			state->devicePeriod = static_cast<Uint64>(frames) * SDL_NS_PER_SECOND / spec.freq;
+		}
+	}
+
+	void Mixer::close() noexcept {
+		// Destroying the stream unbinds it, so the callback can no longer run past this point.
+		stream.reset();
+		device = 0;
+		deviceFrames = 0;
+		state->devicePeriod = 0;
+		paused = true;
+		for (Voice& voice : state->voices) {
+			voice = Voice();
+		}
+		state->tailRemaining = 0;
+	}
+
+	void Mixer::play(std::shared_ptr<const SampleBuffer> samples, GainOverride gain, Uint64 triggerTime, uint32_t delay) {
+		start(std::move(samples), gain, triggerTime, delay, false);
+	}
+
+	void Mixer::replace(std::shared_ptr<const SampleBuffer> samples, GainOverride gain, Uint64 triggerTime, uint32_t delay) {
+		start(std::move(samples), gain, triggerTime, delay, true);
+	}
+
+	void Mixer::start(std::shared_ptr<const SampleBuffer> samples, GainOverride gain, Uint64 triggerTime, uint32_t delay, bool alone) {
+		assert(samples);
+		reportPromotion();
+		if (!stream) {
+			if (alone) {
+				stopVoices();
+			}
+			addVoice(std::move(samples), gain, triggerTime, delay);
+			state->latencyFrames.store(delay, std::memory_order_relaxed);
+			return;
+		}
+
+		{
+			StreamLock lock(stream.get());
+			if (alone) {
+				stopVoices();
+			}
+			addVoice(std::move(samples), gain, triggerTime, delay);
+			if (paused) {
+				state->lastCallback = 0;
+			}
+			const int queued = std::max(SDL_GetAudioStreamQueued(stream.get()), 0) / SDL_AUDIO_FRAMESIZE(mixSpec);
+			state->latencyFrames.store(deviceFrames + static_cast<uint32_t>(queued) + delay, std::memory_order_relaxed);
+		}
+
+		if (paused) {
+			if (!SDL_ResumeAudioStreamDevice(stream.get())) {
+				throw ExternalError(SDL_GetError());
+			}
+			paused = false;
+		}
+	}
+
+	void Mixer::stop() noexcept {
+		if (!stream) {
+			stopVoices();
+			return;
+		}
+		StreamLock lock(stream.get());
+		stopVoices();
+	}
+
+	void Mixer::pauseIfIdle() noexcept {
+		reportPromotion();
+		if (!stream || paused || isPlaying()) {
+			return;
+		}
+		SDL_PauseAudioStreamDevice(stream.get());
+		paused = true;
+	}
+
+	bool Mixer::isPlaying() const noexcept {
+		if (!stream) {
+			return state->hasActiveVoices() || state->tailRemaining > 0;
+		}
+		StreamLock lock(stream.get());
+		return state->hasActiveVoices() || state->tailRemaining > 0;
+	}
+
+	void Mixer::setGain(float gain) noexcept {
+		if (!stream) {
+			state->gain = gain;
+			return;
+		}
+		StreamLock lock(stream.get());
+		state->gain = gain;
+	}
+
+	void Mixer::setTail(uint32_t frames) noexcept {
+		if (!stream) {
+			state->tail = frames;
+			return;
+		}
+		StreamLock lock(stream.get());
+		state->tail = frames;
+	}
+
+	Mixer::Stats Mixer::getStats() const noexcept {
+		Stats stats;
+		stats.periodFrames = deviceFrames;
+		stats.callbacks = state->callbacks.load(std::memory_order_relaxed);
+		stats.xruns = state->xruns.load(std::memory_order_relaxed);
+		stats.renderTime = state->renderTime.getCounts();
+		stats.interval = state->interval.getCounts();
+		stats.queued = state->queued.getCounts();
+		return stats;
+	}
+
+	void Mixer::resetStats() noexcept {
+		state->callbacks.store(0, std::memory_order_relaxed);
+		state->xruns.store(0, std::memory_order_relaxed);
+		state->renderTime.reset();
+		state->interval.reset();
+		state->queued.reset();
+	}
+
+	void Mixer::reportPromotion() noexcept {
+		if (!promotionReported && state->promotionFailed.load(std::memory_order_acquire)) {
+			VI_WARN("Unable to raise audio thread priority: %s", state->promotionError.data());
+			promotionReported = true;
+		}
+	}
+
+	void Mixer::addVoice(std::shared_ptr<const SampleBuffer> samples, GainOverride gain, Uint64 triggerTime, uint32_t delay) noexcept {
+		// Reuse a finished voice, or steal the one that has been playing the longest.
+		Voice* slot = &state->voices[0];
+		for (Voice& voice : state->voices) {
+			if (!voice.active) {
+				slot = &voice;
+				break;
+			}
+			if (voice.position > slot->position) {
+				slot = &voice;
+			}
+		}
+		// Any buffer released here gets freed on this thread rather than the audio thread.
+		slot->samples = std::move(samples);
+		slot->position = 0;
+		slot->delay = delay;
+		slot->gain = gain;
+		slot->triggerTime = triggerTime;
+		slot->active = true;
+	}
+
+	void Mixer::stopVoices() noexcept {
+		for (Voice& voice : state->voices) {
+			voice.active = false;
+		}
+		state->tailRemaining = 0;
+	}
+
+	void SDLCALL Mixer::onAudio(void* userData, SDL_AudioStream* stream, int additional, int total) noexcept {
+		assert(userData);
+		State& state = *static_cast<State*>(userData);
+
+		if (!state.promoted) {
+			// SDL already runs device threads at high priority on most platforms. This makes sure of it.
+			// Logging formats and locks, so the error is only copied here and logged by the next call from another thread.
+			if (!SDL_SetCurrentThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL)) {
+				SDL_strlcpy(state.promotionError.data(), SDL_GetError(), state.promotionError.size());
+				state.promotionFailed.store(true, std::memory_order_release);
+			}
+			state.promoted = true;
+		}
+
+		constexpr int frameSize = SDL_AUDIO_FRAMESIZE(mixSpec);
+		const Uint64 start = SDL_GetTicksNS();
+		if (state.lastCallback != 0) {
+			const Uint64 elapsed = start - state.lastCallback;
+			state.interval.add(elapsed / SDL_NS_PER_US);
+			if (state.devicePeriod != 0 && elapsed * 2 > state.devicePeriod * 3) {
+				state.xruns.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		state.lastCallback = start;
+		state.queued.add(static_cast<uint64_t>(std::max(total - additional, 0) / frameSize));
+
+		bool idle = false;
+		for (int frames = additional / frameSize; frames > 0;) {
+			const int count = std::min(frames, maxChunkFrames);
+			idle |= state.renderChunk(state.chunk.data(), count);
+			SDL_PutAudioStreamData(stream, state.chunk.data(), count * frameSize);
+			frames -= count;
+		}
+		state.renderTime.add((SDL_GetTicksNS() - start) / SDL_NS_PER_US);
+		state.callbacks.fetch_add(1, std::memory_order_relaxed);
+
+		if (idle) {
+			getIdleNotifier().notify();
+		}
+	}
+
+	bool Mixer::State::renderChunk(float* out, int frames) noexcept {
+		const int finished = render(out, frames);
+		if (hasActiveVoices()) {
+			return false;
+		}
+		// The tail is counted on the output clock, starting from the chunk the last voice ended in.
+		if (finished > 0) {
+			tailRemaining = tail;
+			return tail == 0;
+		}
+		if (tailRemaining > 0) {
+			tailRemaining -= std::min(static_cast<uint32_t>(frames), tailRemaining);
+			return tailRemaining == 0;
+		}
+		return false;
+	}
+
+	int Mixer::State::render(float* out, int frames) noexcept {
+		constexpr size_t channels = mixSpec.channels;
+		std::fill_n(out, frames * channels, 0.0f);
+
+		int finished = 0;
+		for (Voice& voice : voices) {
+			if (!voice.active) {
+				continue;
+			}
+
+			// Waiting out the pre-roll. Starts partway into the chunk so the delay stays sample accurate.
+			const uint32_t skip = std::min(static_cast<uint32_t>(frames), voice.delay);
+			voice.delay -= skip;
+			if (skip == static_cast<uint32_t>(frames)) {
+				continue;
+			}
+
+			if (voice.triggerTime != 0) {
+				latency.store(SDL_GetTicksNS() - voice.triggerTime, std::memory_order_relaxed);
+				voice.triggerTime = 0;
+			}
+
+			const SampleBuffer& samples = *voice.samples;
+			const uint32_t count = std::min(frames - skip, samples.getFrames() - voice.position);
+			const float* in = samples.getData() + static_cast<size_t>(voice.position) * channels;
+			float* dest = out + static_cast<size_t>(skip) * channels;
+			const float gain = voice.gain.use ? voice.gain.gain : this->gain;
+
+			for (size_t i = 0; i < count * channels; i++) {
+				dest[i] += in[i] * gain;
+			}
+
+			voice.position += count;
+			if (voice.position >= samples.getFrames()) {
+				voice.active = false;
+				finished++;
+			}
+		}
+		return finished;
+	}
+
+	bool Mixer::State::hasActiveVoices() const noexcept {
+		return std::any_of(voices.begin(), voices.end(), [](const Voice& voice) {
+			return voice.active;
+		});
+	}
+}
\ No newline at end of file
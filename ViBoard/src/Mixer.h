@@ -0,0 +1,172 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Audio.h"
+#include "Histogram.h"
+
+#include <SDL3/SDL.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <assert.h>
+
+namespace vi {
+	// Event pushed once a mixer runs out of voices and its tail has elapsed. Several may be merged into one.
+	Uint32 getPlaybackEventType() noexcept;
+
+	// Mixes any number of sounds into a single output device. Audio is pulled by the device's thread through a callback,
+	// which never allocates, frees, locks or touches unpinned memory of its own. Only SDL's stream does, as it queues the mix.
+	class Mixer {
+	public:
+		static constexpr size_t maxVoices = 16;
+		static constexpr int maxChunkFrames = 1024;
+
+		// How the device has been keeping up since the mixer was opened or the stats were reset.
+		struct Stats {
+			// Size of the device's buffer, in mixSpec frames. 0 if the device did not report it.
+			uint32_t periodFrames = 0;
+			uint64_t callbacks = 0;
+			// Callbacks that came more than one and a half periods after the previous one,
+			// by which time the device has most likely run out of audio and played a gap.
+			uint64_t xruns = 0;
+			// Time spent mixing in each callback, and between callbacks, in microseconds.
+			Histogram::Counts renderTime{};
+			Histogram::Counts interval{};
+			// Frames still queued in the stream when the device asked for more.
+			Histogram::Counts queued{};
+		};
+
+		Mixer();
+
+		Mixer(const Mixer&) = delete;
+		Mixer& operator=(const Mixer&) = delete;
+
+		~Mixer();
+
+		// Does nothing if the mixer is already open on the given device.
+		void open(SDL_AudioDeviceID device);
+		void close() noexcept;
+
+		// triggerTime is when playback was requested, in SDL_GetTicksNS() time, or 0 if it should not be measured.
+		// The sound starts after delay frames of silence. If the mixer is not open, it is only mixed by renderOffline().
+		void play(std::shared_ptr<const SampleBuffer> samples, GainOverride gain, Uint64 triggerTime = 0, uint32_t delay = 0);
+		// Like play(), but stops every other voice first. Done in one go, so the device never plays a gap in between.
+		void replace(std::shared_ptr<const SampleBuffer> samples, GainOverride gain, Uint64 triggerTime = 0, uint32_t delay = 0);
+		void stop() noexcept;
+
+		// Pauses the device once all voices have finished, so an idle mixer costs nothing.
+		void pauseIfIdle() noexcept;
+
+		// True while any voice is playing or waiting to start, and until the tail has elapsed.
+		bool isPlaying() const noexcept;
+		void setGain(float gain) noexcept;
+		// Frames of silence the mixer keeps counting as playing after its last voice ends.
+		void setTail(uint32_t frames) noexcept;
+
+		bool isOpen() const noexcept {
+			return stream != nullptr;
+		}
+
+		// Mixes the next frames into out, which must hold frames * mixSpec.channels samples, exactly as the device
+		// callback would, tail included. Lets benchmarks and tools drive the mixer without a device, so it must not be open.
+		// Returns true if the mixer went idle within these frames.
+		bool renderOffline(float* out, int frames) noexcept {
+			assert(!stream);
+			return state->renderChunk(out, frames);
+		}
+
+		// Time from the last measured trigger until its first samples were queued to the device, in nanoseconds.
+		Uint64 getLatency() const noexcept {
+			return state->latency.load(std::memory_order_relaxed);
+		}
+
+		// Frames that were due to play before the last sound's first sample, when it was played: the device's buffer,
+		// anything still queued in the stream, and the delay. Unlike getLatency(), it does not depend on scheduling.
+		uint32_t getLatencyFrames() const noexcept {
+			return state->latencyFrames.load(std::memory_order_relaxed);
+		}
+
+		Stats getStats() const noexcept;
+		void resetStats() noexcept;
+
+	private:
+		struct Voice {
+			std::shared_ptr<const SampleBuffer> samples;
+			uint32_t position = 0;
+			uint32_t delay = 0;
+			GainOverride gain;
+			Uint64 triggerTime = 0;
+			bool active = false;
+		};
+
+		// Everything the audio thread touches, guarded by the stream lock apart from the atomics. It gets pages of
+		// its own, so pinning it never pins or unpins whatever shares a page with the mixer, such as the other output.
+		struct State {
+			std::array<Voice, maxVoices> voices;
+			std::array<float, maxChunkFrames * mixSpec.channels> chunk{};
+			float gain = 1.0f;
+			uint32_t tail = 0;
+			uint32_t tailRemaining = 0;
+			// Size of the device's buffer, in nanoseconds.
+			Uint64 devicePeriod = 0;
+			bool promoted = false;
+			// SDL's error if raising the audio thread's priority failed. Only read once promotionFailed is set.
+			std::array<char, 128> promotionError{};
+			std::atomic<bool> promotionFailed = false;
+			// When the previous callback started. 0 after the device has been paused, as the gap is then expected.
+			Uint64 lastCallback = 0;
+			std::atomic<Uint64> latency = 0;
+			std::atomic<uint32_t> latencyFrames = 0;
+
+			// Written by the audio thread and read from any other without the stream lock.
+			std::atomic<uint64_t> callbacks = 0;
+			std::atomic<uint64_t> xruns = 0;
+			Histogram renderTime;
+			Histogram interval;
+			Histogram queued;
+
+			// Returns the number of voices that finished during this call.
+			int render(float* out, int frames) noexcept;
+			// Renders one chunk and counts down the tail. Returns true if the mixer went idle in it.
+			bool renderChunk(float* out, int frames) noexcept;
+			bool hasActiveVoices() const noexcept;
+		};
+
+		struct StateDeleter {
+			void operator()(State* state) const noexcept;
+		};
+
+		AudioStreamOwner stream{nullptr, SDL_DestroyAudioStream};
+		SDL_AudioDeviceID device = 0;
+		// Size of the device's buffer, in mixSpec frames.
+		uint32_t deviceFrames = 0;
+		bool paused = true;
+		std::unique_ptr<State, StateDeleter> state;
+		bool locked = false;
+		bool promotionReported = false;
+
+		void reportPromotion() noexcept;
+		void start(std::shared_ptr<const SampleBuffer> samples, GainOverride gain, Uint64 triggerTime, uint32_t delay, bool alone);
+		void addVoice(std::shared_ptr<const SampleBuffer> samples, GainOverride gain, Uint64 triggerTime, uint32_t delay) noexcept;
+		void stopVoices() noexcept;
+		static void SDLCALL onAudio(void* userData, SDL_AudioStream* stream, int additional, int total) noexcept;
+	};
+}
\ No newline at end of file
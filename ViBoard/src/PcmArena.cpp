@@ -0,0 +1,131 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "PcmArena.h"
+#include "Exceptions.h"
+#include "platform/Platform.h"
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <format>
+
+namespace vi {
+	namespace {
+		std::atomic<size_t> pcmMemory = 0;
+		std::atomic<size_t> pcmBudget = 0;
+
+		bool tryReservePcm(size_t size) noexcept {
+			const size_t budget = pcmBudget.load(std::memory_order_relaxed);
+			size_t used = pcmMemory.load(std::memory_order_relaxed);
+			do {
+				if (budget != 0 && (size > budget || used > budget - size)) {
+					return false;
+				}
+			} while (!pcmMemory.compare_exchange_weak(used, used + size, std::memory_order_relaxed));
+			return true;
+		}
+
+		// What is left of the budget, or SIZE_MAX if there is none.
+		size_t getPcmHeadroom() noexcept {
+			const size_t budget = pcmBudget.load(std::memory_order_relaxed);
+			const size_t used = pcmMemory.load(std::memory_order_relaxed);
+			if (budget == 0) {
+				return SIZE_MAX;
+			}
+			return used < budget ? budget - used : 0;
+		}
+	}
+
+	size_t getPcmMemory() noexcept {
+		return pcmMemory.load(std::memory_order_relaxed);
+	}
+
+	void setPcmBudget(size_t bytes) noexcept {
+		pcmBudget.store(bytes, std::memory_order_relaxed);
+	}
+
+	size_t getPcmBudget() noexcept {
+		return pcmBudget.load(std::memory_order_relaxed);
+	}
+
+	void reservePcm(size_t size) {
+		if (!tryReservePcm(size)) {
+			throw RuntimeError(std::format("Decoded sounds would take more than the memory budget of {} MB.", getPcmBudget() >> 20));
+		}
+	}
+
+	void releasePcm(size_t size) noexcept {
+		pcmMemory.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	PcmSlab::PcmSlab(size_t capacity)
+		: capacity(alignToPage(capacity)) {
+		reservePcm(this->capacity);
+		data = static_cast<std::byte*>(SDL_aligned_alloc(getPageSize(), this->capacity));
+		if (!data) {
+			releasePcm(this->capacity);
+			throw ExternalError(SDL_GetError());
+		}
+	}
+
+	PcmSlab::~PcmSlab() {
+		SDL_aligned_free(data);
+		releasePcm(capacity);
+	}
+
+	void* PcmSlab::allocate(size_t size) noexcept {
+		const size_t aligned = alignToPage(size);
+		const size_t offset = used.load(std::memory_order_relaxed);
+		if (aligned > capacity - offset) {
+			return nullptr;
+		}
+		void* block = data + offset;
+		used.store(offset + aligned, std::memory_order_relaxed);
+		live.fetch_add(aligned, std::memory_order_relaxed);
+		return block;
+	}
+
+	void PcmSlab::release(size_t size) noexcept {
+		live.fetch_sub(alignToPage(size), std::memory_order_relaxed);
+	}
+
+	std::pair<void*, std::shared_ptr<PcmSlab>> PcmArena::allocate(size_t size) {
+		std::lock_guard lock(mutex);
+		if (current) {
+			if (void* block = current->allocate(size)) {
+				return {block, current};
+			}
+		}
+
+		if (size > nextSlabSize || alignToPage(nextSlabSize) > getPcmHeadroom()) {
+			// Too big to share a slab, or the budget is nearly used up. Given its own, so the current one keeps filling.
+			auto slab = std::make_shared<PcmSlab>(size);
+			return {slab->allocate(size), std::move(slab)};
+		}
+
+		current = std::make_shared<PcmSlab>(nextSlabSize);
+		nextSlabSize = std::min(nextSlabSize * 2, maxSlabSize);
+		return {current->allocate(size), current};
+	}
+
+	bool PcmArena::shouldCompact(const PcmSlab& slab) const noexcept {
+		std::lock_guard lock(mutex);
+		return &slab != current.get() && slab.isSparse();
+	}
+}
\ No newline at end of file
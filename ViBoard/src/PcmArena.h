@@ -0,0 +1,94 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace vi {
+	// Decoded PCM held across the process, in bytes: every slab, including space that has been released but not
+	// compacted yet, and every block reserved outside of an arena.
+	size_t getPcmMemory() noexcept;
+	// In bytes, or 0 for no limit. Past it, slabs and blocks fail to be reserved with a RuntimeError,
+	// so a sound fails to load as it would for a broken file, rather than memory growing without bound.
+	void setPcmBudget(size_t bytes) noexcept;
+	size_t getPcmBudget() noexcept;
+	// For samples kept outside of any arena. Every reserved block must be released again with the same size.
+	void reservePcm(size_t size);
+	void releasePcm(size_t size) noexcept;
+
+	// One page-aligned block that many sounds' samples are packed into. Lives for as long as the arena still
+	// allocates from it or any buffer placed in it does, mixer voices included.
+	class PcmSlab {
+	public:
+		explicit PcmSlab(size_t capacity);
+
+		PcmSlab(const PcmSlab&) = delete;
+		PcmSlab& operator=(const PcmSlab&) = delete;
+
+		~PcmSlab();
+
+		// Returns null if there is no room left. Every block starts on a page boundary, so each can be locked
+		// and unlocked without touching its neighbours.
+		void* allocate(size_t size) noexcept;
+
+		// Takes the size given to allocate. Only tracks how much is still in use, the space itself is reclaimed by compaction.
+		void release(size_t size) noexcept;
+
+		// True once most of what was handed out has been released again.
+		bool isSparse() const noexcept {
+			return live.load(std::memory_order_relaxed) * 2 < used.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::byte* data = nullptr;
+		size_t capacity = 0;
+		// Only written by the arena allocating from the slab, but read by any other arena whose sounds share it.
+		std::atomic<size_t> used = 0;
+		std::atomic<size_t> live = 0;
+	};
+
+	// Holds the decoded samples of one board, so they end up next to each other rather than as a heap block each,
+	// and get freed a slab at a time when the board goes away. Thread-safe.
+	class PcmArena {
+	public:
+		static constexpr size_t minSlabSize = size_t(1) << 20;
+		static constexpr size_t maxSlabSize = size_t(32) << 20;
+
+		PcmArena() = default;
+
+		PcmArena(const PcmArena&) = delete;
+		PcmArena& operator=(const PcmArena&) = delete;
+
+		// The returned slab must be kept for as long as the block is in use, then have the size released.
+		std::pair<void*, std::shared_ptr<PcmSlab>> allocate(size_t size);
+
+		// True if the slab is worth emptying, so it can be freed. The one still being filled never is.
+		bool shouldCompact(const PcmSlab& slab) const noexcept;
+
+	private:
+		mutable std::mutex mutex;
+		std::shared_ptr<PcmSlab> current;
+		// Slabs double in size up to maxSlabSize, so small boards stay small.
+		size_t nextSlabSize = minSlabSize;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Audio.h"
+#include "SlotMap.h"
+
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace vi {
+	// What triggering a sound reads, kept apart from the Sound as arrays indexed by the slot of its handle.
+	// Slots never move, so sounds can be reordered, swapped around their SlotMap or erased without touching it,
+	// and a hotkey reads one entry of two dense arrays rather than a whole Sound. Generations are left to the SlotMap.
+	class PlaybackTable {
+	public:
+		void assign(Handle<Sound> handle, std::shared_ptr<LazySamples> lazySamples, const SoundGains& soundGains = {}) {
+			if (handle.index >= samples.size()) {
+				samples.resize(handle.index + 1);
+				gains.resize(handle.index + 1);
+			}
+			samples[handle.index] = std::move(lazySamples);
+			gains[handle.index] = soundGains;
+		}
+
+		void setSamples(Handle<Sound> handle, std::shared_ptr<LazySamples> lazySamples) noexcept {
+			assert(handle.index < samples.size());
+			samples[handle.index] = std::move(lazySamples);
+		}
+
+		void release(Handle<Sound> handle) noexcept {
+			assert(handle.index < samples.size());
+			samples[handle.index].reset();
+		}
+
+		void clear() noexcept {
+			samples.clear();
+			gains.clear();
+		}
+
+		LazySamples& getSamples(Handle<Sound> handle) const noexcept {
+			assert(handle.index < samples.size() && samples[handle.index]);
+			return *samples[handle.index];
+		}
+
+		// For playing the samples after letting go of whatever guards this table.
+		std::shared_ptr<LazySamples> shareSamples(Handle<Sound> handle) const noexcept {
+			assert(handle.index < samples.size() && samples[handle.index]);
+			return samples[handle.index];
+		}
+
+		const SoundGains& getGains(Handle<Sound> handle) const noexcept {
+			assert(handle.index < gains.size());
+			return gains[handle.index];
+		}
+
+		void setGain(Handle<Sound> handle, size_t output, GainOverride gain) noexcept {
+			assert(handle.index < gains.size() && output < gains[handle.index].size());
+			gains[handle.index][output] = gain;
+		}
+
+		// Null where a slot is free.
+		std::span<const std::shared_ptr<LazySamples>> getAllSamples() const noexcept {
+			return samples;
+		}
+
+	private:
+		std::vector<std::shared_ptr<LazySamples>> samples;
+		std::vector<SoundGains> gains;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,536 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Settings.h"
+#include "Exceptions.h"
+#include "platform/Hotkey.h"
+
+#include <nlohmann/json.hpp>
+
+#include <limits>
+#include <stdint.h>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	namespace {
+		using json = nlohmann::json;
+
+		// Paths are stored as UTF-8, the same as nlohmann's own path conversion, so they read back unchanged on Windows.
+		std::string toUtf8(const fs::path& path) {
+			const std::u8string string = path.u8string();
+			return std::string(string.begin(), string.end());
+		}
+
+		fs::path fromUtf8(const std::string& string) {
+			return fs::path(std::u8string(string.begin(), string.end()));
+		}
+
+		json toJson(const std::optional<HotkeyBinding>& hotkey) {
+			if (!hotkey) {
+				return nullptr;
+			}
+
+			json hotkeyJson;
+			hotkeyJson["scancode"] = hotkey->scancode;
+			hotkeyJson["raw"] = hotkey->raw;
+			hotkeyJson["mod"] = hotkey->mod;
+			return hotkeyJson;
+		}
+
+		json toJson(const Settings& settings) {
+			json file;
+
+			file["showWelcome"] = settings.showWelcome;
+
+			json& boardArray = file["soundboards"];
+			for (const SoundboardSettings& board : settings.soundboards) {
+				json& boardJson = boardArray.emplace_back();
+				boardJson["path"] = toUtf8(board.path);
+
+				json& soundsMap = boardJson["sounds"];
+				for (const SoundSettings& sound : board.sounds) {
+					json& soundJson = soundsMap[toUtf8(sound.path)];
+					for (const GainOverride& gain : sound.gains) {
+						soundJson["gains"].emplace_back(gain);
+					}
+					soundJson["hotkey"] = toJson(sound.hotkey);
+
+					const SoundInfo& info = sound.info;
+					soundJson["size"] = info.size;
+					soundJson["modified"] = info.modified;
+					soundJson["frames"] = info.frames;
+					soundJson["channels"] = info.channels;
+					soundJson["sampleRate"] = info.sampleRate;
+					soundJson["hash"] = info.hash;
+				}
+			}
+
+			for (const OutputSettings& config : settings.playback) {
+				json& configJson = file["playback"].emplace_back();
+				configJson["preferred"] = config.preferred;
+				configJson["gain"] = config.gain;
+			}
+			file["dualPlayback"] = settings.dualPlayback;
+			file["stopHotkey"] = toJson(settings.stopHotkey);
+			file["theme"] = settings.theme;
+
+			file["minimizeToTray"] = settings.minimizeToTray;
+			file["startMinimized"] = settings.startMinimized;
+
+			file["pttScancode"] = settings.pttScancode;
+			file["pttRaw"] = settings.pttRaw;
+			file["usePtt"] = settings.usePtt;
+			file["pttPreRoll"] = settings.pttPreRoll;
+			file["pttTail"] = settings.pttTail;
+			file["pttToggleHotkey"] = toJson(settings.pttToggleHotkey);
+
+			file["maximized"] = settings.maximized;
+			file["windowX"] = settings.windowBounds.x;
+			file["windowY"] = settings.windowBounds.y;
+			file["windowWidth"] = settings.windowBounds.w;
+			file["windowHeight"] = settings.windowBounds.h;
+
+			file["compactSettings"] = settings.compactSettings;
+			file["memoryBudget"] = settings.memoryBudget;
+			return file;
+		}
+
+		struct Value {
+			enum class Type {
+				Null,
+				Boolean,
+				Integer,
+				// Only for integers too large for int64_t.
+				Unsigned,
+				Float,
+				String
+			};
+
+			Type type = Type::Null;
+			bool boolean = false;
+			int64_t integer = 0;
+			uint64_t unsignedInteger = 0;
+			double number = 0.0;
+			const std::string* string = nullptr;
+
+			bool isNull() const noexcept {
+				return type == Type::Null;
+			}
+
+			bool getBool() const {
+				if (type != Type::Boolean) {
+					throw IOError("Expected a boolean.");
+				}
+				return boolean;
+			}
+
+			template<typename T>
+			T getInt(int64_t min = std::numeric_limits<T>::min(), int64_t max = std::numeric_limits<T>::max()) const {
+				if (type == Type::Unsigned) {
+					throw IOError("Integer out of range.");
+				}
+				if (type != Type::Integer) {
+					throw IOError("Expected an integer.");
+				}
+				if (integer < min || integer > max) {
+					throw IOError("Integer out of range.");
+				}
+				return static_cast<T>(integer);
+			}
+
+			uint64_t getUnsigned() const {
+				if (type == Type::Unsigned) {
+					return unsignedInteger;
+				}
+				return getInt<uint64_t>(0, std::numeric_limits<int64_t>::max());
+			}
+
+			float getFloat(float min, float max) const {
+				double result = number;
+				if (type == Type::Integer) {
+					result = static_cast<double>(integer);
+				} else if (type != Type::Float) {
+					throw IOError("Expected a number.");
+				}
+				if (!(result >= min && result <= max)) {
+					throw IOError("Number out of range.");
+				}
+				return static_cast<float>(result);
+			}
+
+			const std::string& getString() const {
+				if (type != Type::String) {
+					throw IOError("Expected a string.");
+				}
+				return *string;
+			}
+		};
+
+		// Fills Settings from SAX events, tracking where in the document it is with a stack of contexts.
+		// Anything unrecognized is skipped along with everything nested in it.
+		class SettingsReader : public nlohmann::json_sax<json> {
+		public:
+			explicit SettingsReader(Settings& settings) noexcept
+				: settings(settings) {
+			}
+
+			bool null() override {
+				return onValue({});
+			}
+
+			bool boolean(bool value) override {
+				Value result;
+				result.type = Value::Type::Boolean;
+				result.boolean = value;
+				return onValue(result);
+			}
+
+			bool number_integer(number_integer_t value) override {
+				Value result;
+				result.type = Value::Type::Integer;
+				result.integer = value;
+				return onValue(result);
+			}
+
+			bool number_unsigned(number_unsigned_t value) override {
+				if (value <= static_cast<number_unsigned_t>(std::numeric_limits<int64_t>::max())) {
+					return number_integer(static_cast<int64_t>(value));
+				}
+				Value result;
+				result.type = Value::Type::Unsigned;
+				result.unsignedInteger = value;
+				return onValue(result);
+			}
+
+			bool number_float(number_float_t value, const string_t&) override {
+				Value result;
+				result.type = Value::Type::Float;
+				result.number = value;
+				return onValue(result);
+			}
+
+			bool string(string_t& value) override {
+				Value result;
+				result.type = Value::Type::String;
+				result.string = &value;
+				return onValue(result);
+			}
+
+			bool binary(binary_t&) override {
+				return onValue({}, true);
+			}
+
+			bool key(string_t& value) override {
+				// Assigned rather than moved, so the buffer's capacity is reused across keys.
+				currentKey = value;
+				return true;
+			}
+
+			bool start_object(std::size_t) override {
+				if (skipDepth > 0) {
+					skipDepth++;
+					return true;
+				}
+				if (stack.empty()) {
+					stack.push_back(Context::Root);
+					return true;
+				}
+
+				switch (stack.back()) {
+				case Context::Root:
+					if (currentKey == "stopHotkey") {
+						return enterHotkey(settings.stopHotkey);
+					}
+					if (currentKey == "pttToggleHotkey") {
+						return enterHotkey(settings.pttToggleHotkey);
+					}
+					break;
+
+				case Context::Soundboards:
+					settings.soundboards.emplace_back();
+					stack.push_back(Context::Board);
+					return true;
+
+				case Context::Board:
+					if (currentKey == "sounds") {
+						stack.push_back(Context::Sounds);
+						return true;
+					}
+					break;
+
+				case Context::Sounds: {
+					SoundSettings& sound = settings.soundboards.back().sounds.emplace_back();
+					sound.path = fromUtf8(currentKey);
+					stack.push_back(Context::Sound);
+					return true;
+				}
+
+				case Context::Sound:
+					if (currentKey == "hotkey") {
+						return enterHotkey(settings.soundboards.back().sounds.back().hotkey);
+					}
+					break;
+
+				case Context::Gains:
+					if (index < AudioEngine::outputCount) {
+						stack.push_back(Context::Gain);
+						return true;
+					}
+					break;
+
+				case Context::Playback:
+					if (index < AudioEngine::outputCount) {
+						stack.push_back(Context::Output);
+						return true;
+					}
+					break;
+
+				default:
+					break;
+				}
+				skipDepth = 1;
+				return true;
+			}
+
+			bool end_object() override {
+				return leave();
+			}
+
+			bool start_array(std::size_t) override {
+				if (skipDepth > 0) {
+					skipDepth++;
+					return true;
+				}
+				if (stack.empty()) {
+					throw IOError("Settings must be an object.");
+				}
+
+				if (stack.back() == Context::Root && currentKey == "soundboards") {
+					stack.push_back(Context::Soundboards);
+					return true;
+				}
+				if (stack.back() == Context::Root && currentKey == "playback") {
+					stack.push_back(Context::Playback);
+					index = 0;
+					return true;
+				}
+				if (stack.back() == Context::Sound && currentKey == "gains") {
+					stack.push_back(Context::Gains);
+					index = 0;
+					return true;
+				}
+				skipDepth = 1;
+				return true;
+			}
+
+			bool end_array() override {
+				return leave();
+			}
+
+			bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& e) override {
+				throw IOError(e.what());
+			}
+
+		private:
+			enum class Context {
+				Root,
+				Soundboards,
+				Board,
+				Sounds,
+				Sound,
+				Gains,
+				Gain,
+				Hotkey,
+				Playback,
+				Output
+			};
+
+			Settings& settings;
+			std::vector<Context> stack;
+			std::string currentKey;
+			int skipDepth = 0;
+			// Position within the current gains or playback array. Neither nests inside the other.
+			size_t index = 0;
+			HotkeyBinding* hotkey = nullptr;
+
+			bool enterHotkey(std::optional<HotkeyBinding>& binding) {
+				hotkey = &binding.emplace();
+				stack.push_back(Context::Hotkey);
+				return true;
+			}
+
+			bool leave() {
+				if (skipDepth > 0) {
+					skipDepth--;
+					return true;
+				}
+
+				const Context context = stack.back();
+				stack.pop_back();
+				if (context == Context::Gain || context == Context::Output) {
+					index++;
+				} else if (context == Context::Hotkey && (hotkey->scancode >= SDL_SCANCODE_COUNT || !ensureInSupportedRange(hotkey->mod))) {
+					throw IOError("Bad hotkey.");
+				}
+				return true;
+			}
+
+			bool onValue(const Value& value, bool binary = false) {
+				if (skipDepth > 0) {
+					return true;
+				}
+				if (stack.empty() || binary) {
+					throw IOError("Unexpected value.");
+				}
+
+				switch (stack.back()) {
+				case Context::Root:
+					setRoot(value);
+					break;
+
+				case Context::Board:
+					if (currentKey == "path") {
+						settings.soundboards.back().path = fromUtf8(value.getString());
+					}
+					break;
+
+				case Context::Sound:
+					setSound(settings.soundboards.back().sounds.back(), value);
+					break;
+
+				case Context::Gain: {
+					GainOverride& gain = settings.soundboards.back().sounds.back().gains[index];
+					if (currentKey == "gain") {
+						gain.gain = value.getFloat(0.0f, 2.0f);
+					} else if (currentKey == "use") {
+						gain.use = value.getBool();
+					}
+					break;
+				}
+
+				case Context::Hotkey:
+					if (currentKey == "scancode") {
+						hotkey->scancode = static_cast<SDL_Scancode>(value.getInt<int>(SDL_SCANCODE_UNKNOWN, SDL_SCANCODE_COUNT - 1));
+					} else if (currentKey == "raw") {
+						hotkey->raw = value.getInt<uint16_t>();
+					} else if (currentKey == "mod") {
+						hotkey->mod = value.getInt<SDL_Keymod>();
+					}
+					break;
+
+				case Context::Output: {
+					OutputSettings& output = settings.playback[index];
+					if (currentKey == "preferred") {
+						output.preferred = value.getString();
+					} else if (currentKey == "gain") {
+						output.gain = value.getFloat(0.0f, 2.0f);
+					}
+					break;
+				}
+
+				default:
+					throw IOError("Unexpected value.");
+				}
+				return true;
+			}
+
+			void setSound(SoundSettings& sound, const Value& value) {
+				SoundInfo& info = sound.info;
+				if (currentKey == "hotkey" && value.isNull()) {
+					sound.hotkey.reset();
+				} else if (currentKey == "size") {
+					info.size = value.getUnsigned();
+				} else if (currentKey == "modified") {
+					info.modified = value.getInt<int64_t>();
+				} else if (currentKey == "frames") {
+					info.frames = value.getInt<uint32_t>();
+				} else if (currentKey == "channels") {
+					info.channels = value.getInt<uint8_t>();
+				} else if (currentKey == "sampleRate") {
+					info.sampleRate = value.getInt<uint32_t>();
+				} else if (currentKey == "hash") {
+					info.hash = value.getUnsigned();
+				}
+			}
+
+			void setRoot(const Value& value) {
+				if (currentKey == "showWelcome") {
+					settings.showWelcome = value.getBool();
+				} else if (currentKey == "dualPlayback") {
+					settings.dualPlayback = value.getBool();
+				} else if (currentKey == "stopHotkey" && value.isNull()) {
+					settings.stopHotkey.reset();
+				} else if (currentKey == "theme") {
+					settings.theme = value.getInt<int>(0, 3);
+				} else if (currentKey == "minimizeToTray") {
+					settings.minimizeToTray = value.getBool();
+				} else if (currentKey == "startMinimized") {
+					settings.startMinimized = value.getBool();
+				} else if (currentKey == "pttScancode") {
+					settings.pttScancode = static_cast<SDL_Scancode>(value.getInt<int>(SDL_SCANCODE_UNKNOWN, SDL_SCANCODE_COUNT - 1));
+				} else if (currentKey == "pttRaw") {
+					settings.pttRaw = value.getInt<uint16_t>();
+				} else if (currentKey == "usePtt") {
+					settings.usePtt = value.getBool();
+				} else if (currentKey == "pttPreRoll") {
+					settings.pttPreRoll = value.getInt<int>(0, 500);
+				} else if (currentKey == "pttTail") {
+					settings.pttTail = value.getInt<int>(0, 1000);
+				} else if (currentKey == "pttToggleHotkey" && value.isNull()) {
+					settings.pttToggleHotkey.reset();
+				} else if (currentKey == "maximized") {
+					settings.maximized = value.getBool();
+				} else if (currentKey == "windowX") {
+					settings.windowBounds.x = value.getInt<int>();
+				} else if (currentKey == "windowY") {
+					settings.windowBounds.y = value.getInt<int>();
+				} else if (currentKey == "windowWidth") {
+					settings.windowBounds.w = value.getInt<int>();
+				} else if (currentKey == "windowHeight") {
+					settings.windowBounds.h = value.getInt<int>();
+				} else if (currentKey == "compactSettings") {
+					settings.compactSettings = value.getBool();
+				} else if (currentKey == "memoryBudget") {
+					settings.memoryBudget = value.getInt<int>(0, Settings::maxMemoryBudget);
+				}
+			}
+		};
+	}
+
+	std::string serializeSettings(const Settings& settings, SettingsFormat format) {
+		const json file = toJson(settings);
+		if (format == SettingsFormat::Json) {
+			return file.dump();
+		}
+
+		std::string data;
+		json::to_msgpack(file, data);
+		return data;
+	}
+
+	Settings parseSettings(std::string_view data, SettingsFormat format) {
+		Settings settings;
+		SettingsReader reader(settings);
+		const auto inputFormat = format == SettingsFormat::Json ? nlohmann::json::input_format_t::json : nlohmann::json::input_format_t::msgpack;
+		if (!json::sax_parse(data.begin(), data.end(), &reader, inputFormat)) {
+			throw IOError("Unable to parse settings.");
+		}
+		return settings;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Audio.h"
+#include "AudioEngine.h"
+
+#include <SDL3/SDL.h>
+
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vi {
+	struct HotkeyBinding {
+		SDL_Scancode scancode = SDL_SCANCODE_UNKNOWN;
+		uint16_t raw = 0;
+		SDL_Keymod mod = SDL_KMOD_NONE;
+	};
+
+	struct SoundSettings {
+		std::filesystem::path path;
+		SoundGains gains;
+		std::optional<HotkeyBinding> hotkey;
+		SoundInfo info;
+	};
+
+	struct SoundboardSettings {
+		std::filesystem::path path;
+		std::vector<SoundSettings> sounds;
+	};
+
+	struct OutputSettings {
+		std::string preferred;
+		float gain = 1.0f;
+	};
+
+	// A copy of everything that gets saved. Taken on the main thread, so it can be serialized on any other.
+	struct Settings {
+		// In MB.
+		static constexpr int maxMemoryBudget = 1024 * 1024;
+
+		bool showWelcome = true;
+		std::vector<SoundboardSettings> soundboards;
+		std::array<OutputSettings, AudioEngine::outputCount> playback;
+		bool dualPlayback = false;
+		std::optional<HotkeyBinding> stopHotkey;
+		int theme = 0;
+
+		bool minimizeToTray = false;
+		bool startMinimized = false;
+
+		SDL_Scancode pttScancode = SDL_SCANCODE_UNKNOWN;
+		uint16_t pttRaw = 0;
+		bool usePtt = false;
+		// In milliseconds.
+		int pttPreRoll = 80;
+		int pttTail = 200;
+		std::optional<HotkeyBinding> pttToggleHotkey;
+
+		bool maximized = false;
+		SDL_Rect windowBounds{0, 0, 0, 0};
+
+		bool compactSettings = false;
+		// Limit on decoded sounds, in MB. 0 for none.
+		int memoryBudget = 0;
+	};
+
+	enum class SettingsFormat {
+		Json,
+		// MessagePack encoding of the same document. Smaller and faster to parse, for large libraries.
+		MessagePack
+	};
+
+	std::string serializeSettings(const Settings& settings, SettingsFormat format);
+
+	// Streams the document straight into the returned settings without building a DOM. Missing fields keep their defaults
+	// and unknown ones are skipped. Throws IOError if the document is malformed or holds out of range values.
+	Settings parseSettings(std::string_view data, SettingsFormat format);
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SettingsWriter.h"
+#include "Exceptions.h"
+#include "Log.h"
+#include "platform/Platform.h"
+
+#include <algorithm>
+#include <chrono>
+#include <tuple>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	Uint32 getSaveEventType() noexcept {
+		static const Uint32 type = SDL_RegisterEvents(1);
+		return type;
+	}
+
+	SettingsWriter::SettingsWriter() {
+		thread = std::thread(&SettingsWriter::run, this);
+	}
+
+	SettingsWriter::~SettingsWriter() {
+		{
+			std::lock_guard lock(mutex);
+			quitting = true;
+		}
+		condition.notify_one();
+		thread.join();
+	}
+
+	void SettingsWriter::markDirty() noexcept {
+		{
+			std::lock_guard lock(mutex);
+			lastChange = SDL_GetTicks();
+			if (scheduled) {
+				return;
+			}
+			scheduled = true;
+		}
+		condition.notify_one();
+	}
+
+	void SettingsWriter::write(fs::path path, Serializer serializer) {
+		{
+			std::lock_guard lock(mutex);
+			const auto it = std::find_if(pending.begin(), pending.end(), [&path](const PendingWrite& write) {
+				return write.path == path;
+			});
+			if (it != pending.end()) {
+				it->serializer = std::move(serializer);
+			} else {
+				pending.push_back({std::move(path), std::move(serializer)});
+			}
+		}
+		condition.notify_one();
+	}
+
+	void SettingsWriter::writeNow(const fs::path& path, const Serializer& serializer) {
+		// The background thread only takes snapshots off the queue while holding fileMutex, so an older one
+		// is either dropped here or already written.
+		std::lock_guard fileLock(fileMutex);
+		{
+			std::lock_guard lock(mutex);
+			std::erase_if(pending, [&path](const PendingWrite& write) {
+				return write.path == path;
+			});
+		}
+		replaceFile(path, serializer());
+	}
+
+	void SettingsWriter::run() noexcept {
+		std::unique_lock lock(mutex);
+		while (true) {
+			condition.wait(lock, [this]() {
+				return !pending.empty() || scheduled || quitting;
+			});
+
+			// Queued snapshots are written even when quitting. A save that is still waiting on changes to settle is not.
+			if (!pending.empty()) {
+				// Always locked before mutex, the same as writeNow() does.
+				lock.unlock();
+				std::lock_guard fileLock(fileMutex);
+				lock.lock();
+				if (pending.empty()) {
+					continue;
+				}
+
+				const PendingWrite write = std::move(pending.front());
+				pending.erase(pending.begin());
+				lock.unlock();
+				try {
+					replaceFile(write.path, write.serializer());
+					VI_DEBUG("Saved %s", write.path.string().c_str());
+				} catch (const std::exception& e) {
+					// Settings are saved again on the next change and on exit, where failures are reported to the user.
+					VI_ERROR("Unable to save %s: %s", write.path.string().c_str(), e.what());
+					std::ignore = e;
+				}
+				lock.lock();
+				continue;
+			}
+			if (quitting) {
+				return;
+			}
+
+			// Waits again until no change has been made for a full saveDelay.
+			const Uint64 quiet = SDL_GetTicks() - lastChange;
+			if (quiet < saveDelay) {
+				condition.wait_for(lock, std::chrono::milliseconds(saveDelay - quiet), [this]() {
+					return !pending.empty() || quitting;
+				});
+				continue;
+			}
+
+			// Changes made from here on schedule a new save, as the snapshot may already be taken.
+			scheduled = false;
+			requestSnapshot();
+		}
+	}
+
+	void SettingsWriter::requestSnapshot() noexcept {
+		SDL_Event event{};
+		event.user.type = getSaveEventType();
+		event.user.data1 = this;
+		SDL_PushEvent(&event);
+		wakeUpEventLoop();
+	}
+}
\ No newline at end of file
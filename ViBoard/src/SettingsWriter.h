@@ -0,0 +1,87 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vi {
+	// Pushed to the main thread once changes have settled. user.data1 points to the writer,
+	// which expects a snapshot through write() in response.
+	Uint32 getSaveEventType() noexcept;
+
+	// Saves files without blocking the main thread. Bursts of changes are coalesced until none have been made
+	// for saveDelay, and the serializer then runs on a background thread, which replaces the file atomically.
+	// The same thread times the delay, so nothing refers to the writer once it is destroyed.
+	class SettingsWriter {
+	public:
+		using Serializer = std::function<std::string()>;
+
+		// In milliseconds.
+		static constexpr Uint32 saveDelay = 1000;
+
+		SettingsWriter();
+
+		SettingsWriter(const SettingsWriter&) = delete;
+		SettingsWriter& operator=(const SettingsWriter&) = delete;
+
+		// Writes any queued snapshot before returning.
+		~SettingsWriter();
+
+		// Cheap enough to call on every change, including each frame of a slider drag. Thread-safe.
+		void markDirty() noexcept;
+
+		// Queues a snapshot for the background thread, replacing one for the same file that has not been written yet.
+		void write(std::filesystem::path path, Serializer serializer);
+
+		// Writes on the calling thread, after any write in progress. A queued snapshot for the same file is dropped.
+		// Throws on failure.
+		void writeNow(const std::filesystem::path& path, const Serializer& serializer);
+
+	private:
+		std::thread thread;
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		struct PendingWrite {
+			std::filesystem::path path;
+			Serializer serializer;
+		};
+
+		std::vector<PendingWrite> pending;
+		bool quitting = false;
+		// Whether a save event is due once changes settle.
+		bool scheduled = false;
+		Uint64 lastChange = 0;
+
+		// Held for the duration of each write, so a synchronous one never interleaves with the background thread, and while
+		// a snapshot is taken off the queue, so an older one is never written over a synchronous one. Locked before mutex.
+		std::mutex fileMutex;
+
+		void run() noexcept;
+		void requestSnapshot() noexcept;
+	};
+}
\ No newline at end of file
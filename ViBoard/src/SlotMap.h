@@ -0,0 +1,171 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+namespace vi {
+	// Refers to a value in a SlotMap<T>. Outlives the value safely: once it is erased, the handle stops
+	// resolving, even if its slot gets reused. A default constructed handle never resolves.
+	template<typename T>
+	struct Handle {
+		static constexpr uint32_t nullIndex = std::numeric_limits<uint32_t>::max();
+
+		uint32_t index = nullIndex;
+		uint32_t generation = 0;
+
+		constexpr bool operator==(const Handle&) const noexcept = default;
+	};
+
+	// Stores values contiguously with O(1) insertion, removal and lookup through generational handles.
+	// Removal swaps the last value into the gap, so iteration order is not stable.
+	template<typename T>
+	class SlotMap {
+	public:
+		using Handle = vi::Handle<T>;
+		using iterator = typename std::vector<T>::iterator;
+		using const_iterator = typename std::vector<T>::const_iterator;
+
+		Handle insert(T value) {
+			uint32_t index;
+			if (freeHead != Handle::nullIndex) {
+				index = freeHead;
+				freeHead = slots[index].next;
+			} else {
+				index = static_cast<uint32_t>(slots.size());
+				slots.emplace_back();
+			}
+
+			Slot& slot = slots[index];
+			slot.next = static_cast<uint32_t>(values.size());
+			values.push_back(std::move(value));
+			owners.push_back(index);
+			slot.occupied = true;
+			return {index, slot.generation};
+		}
+
+		bool erase(Handle handle) noexcept {
+			if (!contains(handle)) {
+				return false;
+			}
+
+			Slot& slot = slots[handle.index];
+			const uint32_t dense = slot.next;
+			if (dense + 1 != values.size()) {
+				values[dense] = std::move(values.back());
+				owners[dense] = owners.back();
+				slots[owners[dense]].next = dense;
+			}
+			values.pop_back();
+			owners.pop_back();
+
+			slot.generation++;
+			slot.occupied = false;
+			slot.next = freeHead;
+			freeHead = handle.index;
+			return true;
+		}
+
+		void clear() noexcept {
+			for (uint32_t index : owners) {
+				Slot& slot = slots[index];
+				slot.generation++;
+				slot.occupied = false;
+				slot.next = freeHead;
+				freeHead = index;
+			}
+			values.clear();
+			owners.clear();
+		}
+
+		bool contains(Handle handle) const noexcept {
+			return handle.index < slots.size()
+				&& slots[handle.index].occupied
+				&& slots[handle.index].generation == handle.generation;
+		}
+
+		T* get(Handle handle) noexcept {
+			return contains(handle) ? &values[slots[handle.index].next] : nullptr;
+		}
+
+		const T* get(Handle handle) const noexcept {
+			return contains(handle) ? &values[slots[handle.index].next] : nullptr;
+		}
+
+		T& operator[](Handle handle) noexcept {
+			assert(contains(handle));
+			return values[slots[handle.index].next];
+		}
+
+		const T& operator[](Handle handle) const noexcept {
+			assert(contains(handle));
+			return values[slots[handle.index].next];
+		}
+
+		// The handle of a value stored in this map, found from its address.
+		Handle getHandle(const T& value) const noexcept {
+			const size_t dense = static_cast<size_t>(&value - values.data());
+			assert(dense < values.size());
+			const uint32_t index = owners[dense];
+			return {index, slots[index].generation};
+		}
+
+		size_t size() const noexcept {
+			return values.size();
+		}
+
+		bool empty() const noexcept {
+			return values.empty();
+		}
+
+		iterator begin() noexcept {
+			return values.begin();
+		}
+
+		iterator end() noexcept {
+			return values.end();
+		}
+
+		const_iterator begin() const noexcept {
+			return values.begin();
+		}
+
+		const_iterator end() const noexcept {
+			return values.end();
+		}
+
+	private:
+		struct Slot {
+			uint32_t generation = 0;
+			// Index into values while occupied, otherwise the next free slot.
+			uint32_t next = Handle::nullIndex;
+			bool occupied = false;
+		};
+
+		std::vector<Slot> slots;
+		std::vector<T> values;
+		std::vector<uint32_t> owners; // Slot index of each value.
+		uint32_t freeHead = Handle::nullIndex;
+	};
+}
\ No newline at end of file
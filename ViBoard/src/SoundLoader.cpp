@@ -0,0 +1,228 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SoundLoader.h"
+#include "Log.h"
+#include "platform/Platform.h"
+
+#include <format>
+#include <tuple>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	Uint32 getSoundLoadedEventType() noexcept {
+		static const Uint32 type = SDL_RegisterEvents(1);
+		return type;
+	}
+
+	SoundLoader::SoundLoader() {
+		thread = std::thread(&SoundLoader::run, this);
+	}
+
+	SoundLoader::~SoundLoader() {
+		{
+			std::lock_guard lock(mutex);
+			quitting = true;
+		}
+		condition.notify_one();
+		thread.join();
+	}
+
+	void SoundLoader::sync(const fs::path& board, std::shared_ptr<PcmArena> arena, std::span<const Sound* const> sounds) {
+		push({Scan::Kind::Sync, board, std::move(arena), getEntries(sounds)});
+	}
+
+	void SoundLoader::update(const fs::path& board, std::shared_ptr<PcmArena> arena, std::vector<FileChange> changes) {
+		push({Scan::Kind::Update, board, std::move(arena), {}, std::move(changes)});
+	}
+
+	void SoundLoader::compact(std::span<const Sound* const> sounds) {
+		push({Scan::Kind::Compact, {}, nullptr, getEntries(sounds)});
+	}
+
+	std::vector<SoundLoader::Result> SoundLoader::takeResults() {
+		std::lock_guard lock(mutex);
+		return std::exchange(results, {});
+	}
+
+	std::vector<SoundLoader::Entry> SoundLoader::getEntries(std::span<const Sound* const> sounds) {
+		std::vector<Entry> entries;
+		entries.reserve(sounds.size());
+		for (const Sound* sound : sounds) {
+			entries.push_back({sound->getPath(), sound->getInfo(), sound->getLazySamples()});
+		}
+		return entries;
+	}
+
+	void SoundLoader::push(Scan scan) {
+		{
+			std::lock_guard lock(mutex);
+			scans.push_back(std::move(scan));
+		}
+		condition.notify_one();
+	}
+
+	void SoundLoader::run() noexcept {
+		if (!SDL_SetCurrentThreadPriority(SDL_THREAD_PRIORITY_LOW)) {
+			VI_WARN("Unable to lower sound loader priority: %s", SDL_GetError());
+		}
+
+		while (true) {
+			std::unique_lock lock(mutex);
+			condition.wait(lock, [this]() {
+				return !scans.empty() || quitting;
+			});
+			if (quitting) {
+				return;
+			}
+
+			const Scan next = std::move(scans.front());
+			scans.pop_front();
+			lock.unlock();
+
+			if (next.kind == Scan::Kind::Compact) {
+				for (const Entry& entry : next.entries) {
+					try {
+						entry.samples->compact();
+					} catch (const std::exception& e) {
+						// Stays where it is, which is only a waste of memory.
+						VI_WARN("Unable to compact %s: %s", entry.path.string().c_str(), e.what());
+						std::ignore = e;
+					}
+				}
+				continue;
+			}
+
+			Result result = next.kind == Scan::Kind::Update ? applyChanges(next) : scan(next);
+			if (quitting) {
+				return;
+			}
+
+			lock.lock();
+			results.push_back(std::move(result));
+			lock.unlock();
+
+			SDL_Event event{};
+			event.user.type = getSoundLoadedEventType();
+			event.user.data1 = this;
+			SDL_PushEvent(&event);
+			wakeUpEventLoop();
+		}
+	}
+
+	SoundLoader::Result SoundLoader::scan(const Scan& scan) {
+		Result result;
+		result.board = scan.board;
+
+		std::unordered_map<fs::path, const Entry*> remaining;
+		remaining.reserve(scan.entries.size());
+		for (const Entry& entry : scan.entries) {
+			remaining.emplace(entry.path, &entry);
+		}
+
+		const auto onError = [&result](const fs::path& path, const std::exception& e) {
+			result.errors.push_back(std::format("{}: {}", path.filename().string(), e.what()));
+		};
+
+		try {
+			if (fs::exists(scan.board)) {
+				for (const fs::directory_entry& file : fs::directory_iterator(scan.board)) {
+					if (quitting) {
+						return result;
+					}
+					if (!file.is_regular_file() || !isSupported(file.path().extension())) {
+						continue;
+					}
+
+					const auto it = remaining.find(file.path());
+					if (it == remaining.end()) {
+						try {
+							result.added.emplace_back(file.path(), scan.arena);
+						} catch (const std::exception& e) {
+							onError(file.path(), e);
+						}
+						continue;
+					}
+
+					const Entry& entry = *it->second;
+					remaining.erase(it);
+					if (entry.info.isCurrent(file)) {
+						continue;
+					}
+
+					try {
+						SoundInfo info;
+						entry.samples->reload(entry.path, info);
+						result.updated.emplace_back(entry.path, info);
+					} catch (const std::exception& e) {
+						onError(entry.path, e);
+					}
+				}
+			}
+		} catch (const fs::filesystem_error& e) {
+			// The folder could not be read through, which says nothing about whether the rest of its files still exist.
+			VI_ERROR("Unable to scan %s: %s", scan.board.string().c_str(), e.what());
+			result.errors.push_back(e.what());
+			return result;
+		}
+
+		for (const auto& [path, entry] : remaining) {
+			result.removed.push_back(path);
+		}
+		return result;
+	}
+
+	SoundLoader::Result SoundLoader::applyChanges(const Scan& scan) {
+		Result result;
+		result.board = scan.board;
+
+		// Only the last change to each file matters.
+		std::unordered_map<fs::path, FileAction> latest;
+		for (const FileChange& change : scan.changes) {
+			if (change.action == FileAction::Rescan) {
+				result.rescan = true;
+				return result;
+			}
+			latest[change.path] = change.action;
+		}
+
+		for (const auto& [path, action] : latest) {
+			if (quitting) {
+				return result;
+			}
+			if (!isSupported(path.extension())) {
+				continue;
+			}
+			if (action == FileAction::Removed) {
+				result.removed.push_back(path);
+				continue;
+			}
+
+			try {
+				result.added.emplace_back(path, scan.arena);
+			} catch (const std::exception& e) {
+				// Likely still being written or deleted again, in which case another change follows.
+				VI_WARN("Unable to load %s: %s", path.string().c_str(), e.what());
+				std::ignore = e;
+			}
+		}
+		return result;
+	}
+}
\ No newline at end of file
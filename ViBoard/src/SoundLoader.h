@@ -0,0 +1,118 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Audio.h"
+#include "platform/DirectoryWatcher.h"
+
+#include <SDL3/SDL.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace vi {
+	// Pushed to the main thread whenever a board's folder has been scanned. user.data1 points to the loader,
+	// whose results are then collected with takeResults().
+	Uint32 getSoundLoadedEventType() noexcept;
+
+	// Reconciles boards with their folders and decodes their sounds on a background thread, so boards built from
+	// the saved manifest can be shown and have their hotkeys registered before any file has been read.
+	class SoundLoader {
+	public:
+		// What a scan found changed, for the main thread to apply to the board.
+		struct Result {
+			std::filesystem::path board;
+			// Decoded sounds for files missing from the board. Ones reported by the watcher may already be on it,
+			// having been modified, or be renamed copies of removed ones.
+			std::vector<Sound> added;
+			// Files that no longer exist.
+			std::vector<std::filesystem::path> removed;
+			// Fresh info for files that changed or had none. Their samples have already been replaced.
+			std::vector<std::pair<std::filesystem::path, SoundInfo>> updated;
+			// Files that could not be decoded.
+			std::vector<std::string> errors;
+			// Set when the watcher lost track of the folder, which then needs a full sync.
+			bool rescan = false;
+		};
+
+		SoundLoader();
+
+		SoundLoader(const SoundLoader&) = delete;
+		SoundLoader& operator=(const SoundLoader&) = delete;
+
+		// Abandons any work not yet done.
+		~SoundLoader();
+
+		// Queues a scan of the board's folder against its sounds as they are now. New and changed sounds are decoded
+		// into the board's arena. Unchanged ones are left to be decoded when first played.
+		void sync(const std::filesystem::path& board, std::shared_ptr<PcmArena> arena, std::span<const Sound* const> sounds);
+		// Queues changes reported by the directory watcher. Thread-safe.
+		void update(const std::filesystem::path& board, std::shared_ptr<PcmArena> arena, std::vector<FileChange> changes);
+		// Queues compaction of the sounds' samples, for once some of the board's have been released. Posts no result.
+		void compact(std::span<const Sound* const> sounds);
+
+		std::vector<Result> takeResults();
+
+	private:
+		struct Entry {
+			std::filesystem::path path;
+			SoundInfo info;
+			std::shared_ptr<LazySamples> samples;
+		};
+
+		struct Scan {
+			enum class Kind {
+				Sync,
+				Update,
+				Compact
+			};
+
+			Kind kind = Kind::Sync;
+			std::filesystem::path board;
+			std::shared_ptr<PcmArena> arena;
+			// The board's sounds when a sync or compaction was queued.
+			std::vector<Entry> entries;
+			// Set instead for changes from the watcher, which only touch the files named.
+			std::vector<FileChange> changes;
+		};
+
+		std::thread thread;
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<Scan> scans;
+		std::vector<Result> results;
+		std::atomic<bool> quitting = false;
+
+		static std::vector<Entry> getEntries(std::span<const Sound* const> sounds);
+		void push(Scan scan);
+		void run() noexcept;
+		Result scan(const Scan& scan);
+		Result applyChanges(const Scan& scan);
+	};
+}
\ No newline at end of file
@@ -26,6 +26,14 @@ namespace vi {
 		AppState() = default;
 		virtual ~AppState() = default;
 
+		// Called once the window and ImGui exist, which may be well after construction. Never called when running headless.
+		virtual void initGui() {}
+
+		// If true, the window stays hidden at launch and the GUI is only initialized once it is first shown.
+		virtual bool startsHidden() const noexcept {
+			return false;
+		}
+
 		virtual void onEvent(const SDL_Event& event) = 0;
 		virtual void update() = 0;
 
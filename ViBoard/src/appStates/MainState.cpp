@@ -20,7 +20,7 @@
 #include "../Application.h"
 #include "../Log.h"
 #include "../Exceptions.h"
-#include "../platform/HotKey.h"
+#include "../platform/Hotkey.h"
 #include "../ImGuiConfig.h"
 
 #include <SDL3/SDL.h>
@@ -28,11 +28,12 @@
 #include <imgui.h>
 #include <imgui_internal.h>
 
-#include <nlohmann/json.hpp>
-
 #include <algorithm>
 #include <fstream>
 #include <unordered_set>
+#include <unordered_map>
+#include <charconv>
+#include <mutex>
 
 using namespace std::string_literals;
 namespace fs = std::filesystem;
@@ -41,9 +42,17 @@ namespace vi {
 	namespace {
 		constexpr ImVec2 buttonSize(0.0f, 32.0f);
 
+		// Pushed once hotkey errors are waiting to be shown.
+		Uint32 getPlayErrorEventType() noexcept {
+			static const Uint32 type = SDL_RegisterEvents(1);
+			return type;
+		}
+
 		const std::filesystem::path settingsPath = storagePath / "settings.json";
+		const std::filesystem::path compactSettingsPath = storagePath / "settings.bin";
 		const std::filesystem::path imGuiPath = storagePath / "imgui.ini";
 
+		// Only records the folder. Its sounds are found and decoded by the loader once the board is added.
 		void browseFiles(void* userData, const char* const* fileList, int filter) noexcept {
 			SDL_assert(userData);
 			if (!fileList || *fileList == nullptr || !fs::exists(*fileList)) {
@@ -52,103 +61,101 @@ namespace vi {
 
 			VI_INFO("Folder opened: %s", fileList[0]);
 			auto& data = *reinterpret_cast<BrowseUserData*>(userData);
-			data.result.path = fs::absolute(fileList[0]);
-
-			for (const auto& entry : fs::directory_iterator(data.result.path)) {
-				if (!entry.is_regular_file() || !isSupported(entry.path().extension())) {
-					continue;
-				}
-
-				try {
-					data.result.sounds.emplace_back(entry.path());
-				} catch (const std::exception& e) {
-					const std::string message = std::format(
-						"Unable to load sound \"{}\".\n"
-						"Please ensure that the file is in correct format and that the program has read permission for that directory.\n\n"
-						"Error: {}",
-						entry.path().string(),
-						e.what()
-					);
-
-					SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Failed to load sound!", message.c_str(), data.window);
-				}
-			}
+			data.result = fs::absolute(fileList[0]);
 			data.ready = true;
 		}
 
-		void refresh(Soundboard& board) noexcept {
-			if (!fs::exists(board.path)) {
-				board.sounds.clear();
-				return;
+		std::vector<std::string_view> splitArguments(std::string_view command) noexcept {
+			std::vector<std::string_view> args;
+			size_t start = command.find_first_not_of(' ');
+			while (start != std::string_view::npos) {
+				const size_t end = command.find(' ', start);
+				args.push_back(command.substr(start, end - start));
+				start = command.find_first_not_of(' ', end);
 			}
+			if (args.empty()) {
+				args.emplace_back();
+			}
+			return args;
+		}
 
-			std::unordered_set<fs::path> files;
-			for (const auto& entry : fs::directory_iterator(board.path)) {
-				if (entry.is_regular_file() && isSupported(entry.path().extension())) {
-					files.insert(entry);
-				}
+		template<typename T>
+		bool parseArgument(std::string_view arg, T& value) noexcept {
+			const auto [end, error] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+			return error == std::errc() && end == arg.data() + arg.size();
+		}
+
+		// Finds a sound by "<board folder>/<file name>". The file extension may be left out.
+		const Sound* findSound(const SlotMap<Soundboard>& soundboards, const SlotMap<Sound>& sounds, std::string_view path) noexcept {
+			const size_t separator = path.rfind('/');
+			if (separator == std::string_view::npos) {
+				return nullptr;
 			}
+			const std::string_view boardName = path.substr(0, separator);
+			const std::string_view soundName = path.substr(separator + 1);
 
-			for (auto soundIt = board.sounds.begin(); soundIt != board.sounds.end();) {
-				const auto compareIt = files.find(soundIt->getPath());
-				if (compareIt != files.end()) {
-					files.erase(compareIt);
-					soundIt++;
-				} else {
-					soundIt = board.sounds.erase(soundIt);
-					if (soundIt == board.sounds.end()) {
-						break;
+			for (const Soundboard& board : soundboards) {
+				if (board.path.filename().string() != boardName) {
+					continue;
+				}
+				for (const SoundHandle handle : board.sounds) {
+					const Sound& sound = sounds[handle];
+					const fs::path& file = sound.getPath();
+					if (file.filename().string() == soundName || file.stem().string() == soundName) {
+						return &sound;
 					}
 				}
 			}
+			return nullptr;
+		}
 
-			for (const auto& file : files) {
-				board.sounds.emplace_back(file);
-			}
+		// How remote clients refer to a board or sound across changes to the library: "#" followed by its handle packed
+		// into one number.
+		template<typename T>
+		std::string formatId(Handle<T> handle) {
+			return std::format("#{}", static_cast<uint64_t>(handle.generation) << 32 | handle.index);
 		}
 
-		nlohmann::json serializeHotkey(HotkeyId id) noexcept {
-			if (!isValidHotkey(id)) {
-				return nullptr;
+		template<typename T>
+		bool parseId(std::string_view arg, Handle<T>& handle) noexcept {
+			uint64_t id = 0;
+			if (!arg.starts_with('#') || !parseArgument(arg.substr(1), id)) {
+				return false;
 			}
-
-			const Hotkey& hotkey = getHotkey(id);
-			nlohmann::json json;
-			json["scancode"] = hotkey.scancode;
-			json["raw"] = hotkey.raw;
-			json["mod"] = hotkey.mod;
-			return json;
+			handle.index = static_cast<uint32_t>(id);
+			handle.generation = static_cast<uint32_t>(id >> 32);
+			return true;
 		}
 
-		Hotkey deserializeHotkey(const nlohmann::json& json) {
-			Hotkey hotkey;
-			json.at("scancode").get_to(hotkey.scancode);
-			json.at("raw").get_to(hotkey.raw);
-			json.at("mod").get_to(hotkey.mod);
+		std::string getPlayErrorMessage(const Sound& sound, const char* error) noexcept {
+			return std::format(
+				"Unable to play sound \"{}\".\n"
+				"Please ensure the sound is in correct format or try a different playback device.\n\n"
+				"Error: {}",
+				sound.getPath().filename().string(),
+				error
+			);
+		}
 
-			if (hotkey.scancode < SDL_SCANCODE_UNKNOWN || hotkey.scancode >= SDL_SCANCODE_COUNT || !ensureInSupportedRange(hotkey.mod)) {
-				throw IOError("Bad hotkey.");
-			}
-			return hotkey;
+		// Done in 64 bits, as a budget in bytes can be more than size_t holds on 32-bit builds.
+		void applyMemoryBudget(int megabytes) noexcept {
+			const uint64_t bytes = static_cast<uint64_t>(megabytes) << 20;
+			setPcmBudget(static_cast<size_t>(std::min<uint64_t>(bytes, SIZE_MAX)));
 		}
 
-		inline HotkeyId tryRegisterHotkey(const Hotkey& hotkey, SDL_Window* window) noexcept {
+		inline HotkeyId tryRegisterHotkey(const Hotkey& hotkey, const Application& app) noexcept {
 			const HotkeyId id = registerHotkey(hotkey);
 			if (id == nullHotkey) {
-				SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-					"Failed to register hotkey!",
-					"An error occured while registering hotkey. It may already be in use by another program.",
-					window);
+				app.showError("Failed to register hotkey!",
+					"An error occured while registering hotkey. It may already be in use by another program.");
 			}
 			return id;
 		}
 
-		inline bool tryUnregisterHotkey(HotkeyId id, SDL_Window* window) noexcept {
+		inline bool tryUnregisterHotkey(HotkeyId id, const Application& app) noexcept {
 			if (!unregisterHotkey(id)) {
-				SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-					"Failed to register hotkey!",
-					"An error occured while registering hotkey. It may already be in use by another program.",
-					window);
+				app.showError("Failed to register hotkey!",
+					"An error occured while registering hotkey. It may already be in use by another program.");
 				return false;
 			}
 			return true;
@@ -158,47 +165,121 @@ namespace vi {
 	MainState::MainState(Application& app)
 		: app(&app) {
 
+		initDirectoryWatcher([this](const fs::path& directory, std::vector<FileChange> changes) {
+			std::shared_ptr<PcmArena> arena;
+			{
+				std::lock_guard lock(libraryMutex);
+				const auto board = std::find_if(soundboards.begin(), soundboards.end(), [&directory](const Soundboard& board) {
+					return board.path == directory;
+				});
+				if (board == soundboards.end()) {
+					return;
+				}
+				arena = board->arena;
+			}
+			soundLoader.update(directory, std::move(arena), std::move(changes));
+		});
+
 		if (!fs::exists(storagePath)) {
 			fs::create_directory(storagePath);
-			ImGui::LoadIniSettingsFromDisk("res/default.ini");
 			loadExampleSoundboard();
-		} else {
-			if (fs::exists(settingsPath)) {
-				try {
-					deserialize();
-				} catch (std::exception& e) {
-					SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-						"Error loading settings!",
-						("An occured while loading user settings. Some settings may be reset to their defaults.\n\n"
-							"Error: "s + e.what()).c_str(),
-						app.getWindow());
-				}
+		} else if (fs::exists(settingsPath) || fs::exists(compactSettingsPath)) {
+			try {
+				deserialize();
+			} catch (std::exception& e) {
+				app.showError("Error loading settings!",
+					"An occured while loading user settings. Some settings may be reset to their defaults.\n\n"
+					"Error: "s + e.what());
 			}
-			ImGui::LoadIniSettingsFromDisk(fs::exists(imGuiPath) ? imGuiPath.string().c_str() : "res/default.ini");
 		}
-
-		if (minimizeToTray) {
+		updateOutputs();
+		engine.setPushToTalkTiming(pttPreRoll, pttTail);
+		initControlSocket([this](std::string_view command) {
+			return onControlCommand(command);
+		});
+
+		// The tray comes up before the GUI, as it is how a window that starts hidden gets shown.
+		if (minimizeToTray && !app.isHeadless()) {
 			createTray();
 		}
-		if (!minimizeToTray || !startMinimized) {
-			SDL_ShowWindow(app.getWindow());
+	}
+
+	void MainState::initGui() {
+		ImGui::LoadIniSettingsFromDisk(fs::exists(imGuiPath) ? imGuiPath.string().c_str() : "res/default.ini");
+
+		if (maximized) {
+			SDL_MaximizeWindow(app->getWindow());
+		} else if (windowBounds.w > 0 && windowBounds.h > 0) {
+			SDL_SetWindowPosition(app->getWindow(), windowBounds.x, windowBounds.y);
+			SDL_SetWindowSize(app->getWindow(), windowBounds.w, windowBounds.h);
 		}
 
 		setTheme();
+		guiInitialized = true;
+	}
+
+	bool MainState::startsHidden() const noexcept {
+		return minimizeToTray && startMinimized && app->tray;
 	}
 
 	MainState::~MainState() noexcept {
 		try {
-			serialize();
-			ImGui::SaveIniSettingsToDisk(imGuiPath.string().c_str());
+			settingsWriter.writeNow(getSettingsPath(), [this]() {
+				return serializeSettings(snapshotSettings(), getSettingsFormat());
+			});
+			if (guiInitialized) {
+				ImGui::SaveIniSettingsToDisk(imGuiPath.string().c_str());
+			}
 		} catch (std::exception& e) {
 			onExitError(e.what());
 		} catch (...) {
 			onExitError("unknown exception");
 		}
+
+		quitControlSocket();
+		quitDirectoryWatcher();
+
+		// Hotkey callbacks point back to this state, so none may be registered or running once it is gone.
+		if (isValidHotkey(stopHotkey)) {
+			unregisterHotkey(stopHotkey);
+		}
+		if (isValidHotkey(pttToggleHotkey)) {
+			unregisterHotkey(pttToggleHotkey);
+		}
+		{
+			std::lock_guard lock(libraryMutex);
+			soundboards.clear();
+			sounds.clear();
+			soundPlayback.clear();
+		}
+		flushHotkeys();
 	}
 
 	void MainState::onEvent(const SDL_Event& event) noexcept {
+		if (event.type == getPlaybackEventType()) {
+			engine.onPlaybackFinished();
+			return;
+		}
+		if (event.type == getSaveEventType()) {
+			saveSettings();
+			return;
+		}
+		if (event.type == getSoundLoadedEventType()) {
+			applyLoadResults();
+			return;
+		}
+		if (event.type == getPlayErrorEventType()) {
+			std::vector<std::string> errors;
+			{
+				std::lock_guard lock(playErrorMutex);
+				errors.swap(playErrors);
+			}
+			for (const std::string& error : errors) {
+				app->showError("Failed to play sound!", error);
+			}
+			return;
+		}
+
 		switch (event.type) {
 		case SDL_EVENT_AUDIO_DEVICE_ADDED: {
 			if (!SDL_IsAudioDevicePlayback(event.adevice.which)) {
@@ -218,6 +299,7 @@ namespace vi {
 					break;
 				}
 			}
+			updateOutputs();
 			break;
 		}
 
@@ -238,6 +320,7 @@ namespace vi {
 			}
 			audioDevices.erase(it);
 			deviceNames.erase(deviceNames.begin() + index);
+			updateOutputs();
 			break;
 		}
 
@@ -257,11 +340,16 @@ namespace vi {
 					break;
 				}
 
-				assert(keyAssign.id);
+				HotkeyId* const target = getKeyAssignTarget();
+				if (!target) {
+					keyAssign.assigning = false;
+					keyAssign.showMenu = false;
+					break;
+				}
 
-				if (isValidHotkey(*keyAssign.id)) {
-					tryUnregisterHotkey(*keyAssign.id, app->getWindow());
-					*keyAssign.id = nullHotkey;
+				if (isValidHotkey(*target)) {
+					tryUnregisterHotkey(*target, *app);
+					*target = nullHotkey;
 				}
 
 				if (event.key.scancode != SDL_SCANCODE_DELETE || mainMod != SDL_KMOD_NONE) {
@@ -270,10 +358,11 @@ namespace vi {
 					hotkey.raw = event.key.raw;
 					hotkey.mod = mod;
 					hotkey.callback = keyAssign.action;
-					*keyAssign.id = tryRegisterHotkey(hotkey, app->getWindow());
+					*target = tryRegisterHotkey(hotkey, *app);
 				}
 
 				keyAssign.assigning = false;
+				settingsWriter.markDirty();
 			} else if (pttAssign.assigning) {
 				if (event.key.scancode == SDL_SCANCODE_DELETE) {
 					pttScancode = SDL_SCANCODE_UNKNOWN;
@@ -282,19 +371,26 @@ namespace vi {
 					pttScancode = event.key.scancode;
 					pttRaw = event.key.raw;
 				}
+				engine.setPushToTalkKey(pttScancode, pttRaw);
 				pttAssign.assigning = false;
+				settingsWriter.markDirty();
 			}
 			break;
 
 		case SDL_EVENT_WINDOW_MINIMIZED:
-			serialize();
+			saveSettings();
+			break;
+
+		case SDL_EVENT_WINDOW_MOVED:
+		case SDL_EVENT_WINDOW_RESIZED:
+		case SDL_EVENT_WINDOW_MAXIMIZED:
+		case SDL_EVENT_WINDOW_RESTORED:
+			settingsWriter.markDirty();
 			break;
 		}
 	}
 
 	void MainState::update() noexcept {
-		app->canSleep = !playback[0].stream && !playback[1].stream;
-
 		if (showWelcome) {
 			ImGui::PushStyleVarX(ImGuiStyleVar_FramePadding, 8.0f);
 			showWelcomeScreen();
@@ -318,38 +414,23 @@ namespace vi {
 
 		ImGui::EndDisabled();
 		ImGui::PopStyleVar();
-
-		if (pttScancode != SDL_SCANCODE_UNKNOWN) {
-			if (usePtt && (playback[0].stream || playback[1].stream)) {
-				sendKeyPress(pttRaw, true);
-				pttActive = true;
-			} else if (pttActive) {
-				sendKeyPress(pttRaw, false);
-				pttActive = false;
-			}
-		}
-
-		for (PlaybackConfig& config : playback) {
-			if (config.stream && SDL_GetAudioStreamAvailable(config.stream.get()) <= 0) {
-				config.stream.reset();
-			}
-		}
 	}
 
 	void MainState::showSoundboards() noexcept {
 		if (browseData.ready) {
-			soundboards.push_back(std::move(browseData.result));
+			syncSoundboard(addSoundboard(std::move(browseData.result), std::make_shared<PcmArena>(), {}));
 			browseData.ready = false;
+			settingsWriter.markDirty();
 		}
 
-		for (size_t boardIndex = 0; boardIndex < soundboards.size();) {
-			Soundboard& board = soundboards[boardIndex];
-
+		std::vector<SoundboardHandle> closed;
+		for (const Soundboard& board : soundboards) {
 			bool keep = true;
 			const std::string boardName = board.path.filename().string();
 			ImGui::SetNextWindowSize(ImVec2(928, 719), ImGuiCond_FirstUseEver);
 
-			ImGui::PushID(static_cast<int>(boardIndex));
+			const SoundboardHandle boardHandle = soundboards.getHandle(board);
+			ImGui::PushID(static_cast<int>(boardHandle.index));
 			ImGui::Begin(boardName.c_str(), &keep);
 
 			constexpr ImVec2 soundButtonSize(180.0f, 64.0f);
@@ -358,30 +439,37 @@ namespace vi {
 			if (ImGui::BeginTable("soundTable", columns)) {
 				ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(10.0f, 10.0f));
 				int c = 0;
-				for (size_t soundIndex = 0; soundIndex < board.sounds.size(); soundIndex++) {
+				for (const SoundHandle handle : board.sounds) {
 					ImGui::TableNextColumn();
 
-					Sound& sound = board.sounds[soundIndex];
+					Sound& sound = sounds[handle];
 					std::string name = sound.getPath().filename().string();
 					if (*sound.getHotkeyId() != nullHotkey) {
 						name += std::format("\n({})", getHotkeyName(*sound.getHotkeyId()));
 					}
 
 					if (ImGui::Button(name.c_str(), soundButtonSize)) {
-						tryPlay(sound);
+						tryPlay(handle);
 					} else if (ImGui::BeginPopupContextItem(name.c_str(), ImGuiPopupFlags_MouseButtonRight | ImGuiPopupFlags_NoOpenOverExistingPopup)) {
 						if (ImGui::MenuItem("Add hotkey")) {
 							keyAssign.showMenu = true;
-							keyAssign.id = sound.getHotkeyId();
-							keyAssign.action = [this, boardIndex, soundIndex]() {
-								tryPlay(soundboards[boardIndex].sounds[soundIndex]);
+							keyAssign.sound = handle;
+							keyAssign.id = nullptr;
+							keyAssign.action = [this, handle]() {
+								playFromHotkey(handle);
 							};
 						} else if (ImGui::MenuItem(("Set volume"))) {
 							soundVolumeMenu.showMenu = true;
-							soundVolumeMenu.sound = soundIndex;
-							soundVolumeMenu.board = boardIndex;
+							soundVolumeMenu.sound = handle;
 						}
 						ImGui::EndPopup();
+					} else if (ImGui::BeginItemTooltip()) {
+						if (const std::shared_ptr<const SampleBuffer> samples = soundPlayback.getSamples(handle).get()) {
+							ImGui::Text("%.1f MB decoded", static_cast<double>(samples->getSize()) / (1024 * 1024));
+						} else {
+							ImGui::Text("Not decoded yet");
+						}
+						ImGui::EndTooltip();
 					}
 
 					if (++c >= columns) {
@@ -410,14 +498,16 @@ namespace vi {
 			ImGui::PopID();
 
 			if (!keep) {
-				soundboards.erase(soundboards.begin() + boardIndex);
-			} else {
-				boardIndex++;
-				if (refreshRequested) {
-					refresh(board);
-				}
+				closed.push_back(boardHandle);
+			} else if (refreshRequested) {
+				syncSoundboard(board);
 			}
 		}
+
+		for (const SoundboardHandle handle : closed) {
+			removeSoundboard(handle);
+			settingsWriter.markDirty();
+		}
 	}
 
 	void MainState::showOptions() noexcept {
@@ -428,13 +518,22 @@ namespace vi {
 
 		ImGui::Text("Output device");
 		ImGui::SetNextItemWidth(selectablesWidth);
-		ImGui::Combo("##output1", &playback[0].deviceIndex, deviceNames.data(), static_cast<int>(deviceNames.size()), 10);
-		ImGui::Checkbox("Add secondary output", &dualPlayback);
+		if (ImGui::Combo("##output1", &playback[0].deviceIndex, deviceNames.data(), static_cast<int>(deviceNames.size()), 10)) {
+			updateOutputs();
+			settingsWriter.markDirty();
+		}
+		if (ImGui::Checkbox("Add secondary output", &dualPlayback)) {
+			updateOutputs();
+			settingsWriter.markDirty();
+		}
 
 		if (dualPlayback) {
 			ImGui::Text("Secondary output device");
 			ImGui::SetNextItemWidth(selectablesWidth);
-			ImGui::Combo("##output2", &playback[1].deviceIndex, deviceNames.data(), static_cast<int>(deviceNames.size()), 10);
+			if (ImGui::Combo("##output2", &playback[1].deviceIndex, deviceNames.data(), static_cast<int>(deviceNames.size()), 10)) {
+				updateOutputs();
+				settingsWriter.markDirty();
+			}
 		}
 
 		ImGui::NewLine();
@@ -449,24 +548,32 @@ namespace vi {
 			showGainSlider(1);
 		}
 
-		ImGui::BeginDisabled(!playback[0].stream && !playback[1].stream);
+		ImGui::BeginDisabled(!engine.isPlaying());
 		if (ImGui::Button("Stop", buttonSize)) {
-			stop();
+			engine.stop();
 		}
 		ImGui::EndDisabled();
 		ImGui::SameLine();
 		if (ImGui::Button("Add stop hotkey", buttonSize)) {
 			keyAssign.showMenu = true;
+			keyAssign.sound = {};
 			keyAssign.id = &stopHotkey;
 			keyAssign.action = [this]() {
-				stop();
+				engine.stop();
 			};
 		}
 		const std::string stopHotkeyLabel = std::format("Stop hotkey: {}.", getHotkeyName(stopHotkey));
 		ImGui::Text(stopHotkeyLabel.c_str());
+		if (const Uint64 latency = engine.getLatency(); latency != 0) {
+			ImGui::TextDisabled("Last hotkey latency: %.1f ms.", static_cast<double>(latency) / SDL_NS_PER_MS);
+		}
 		ImGui::NewLine();
 
-		ImGui::Checkbox("Send push-to-talk key", &usePtt);
+		bool usePtt = engine.isPushToTalkEnabled();
+		if (ImGui::Checkbox("Send push-to-talk key", &usePtt)) {
+			engine.setPushToTalkEnabled(usePtt);
+			settingsWriter.markDirty();
+		}
 
 		ImVec4 textCol = ImGui::GetStyleColorVec4(ImGuiCol_Text);
 		textCol.w = 0.7f;
@@ -485,18 +592,31 @@ namespace vi {
 
 		if (ImGui::Button("Add toggle hotkey", addPttButtonSize)) {
 			keyAssign.showMenu = true;
+			keyAssign.sound = {};
 			keyAssign.id = &pttToggleHotkey;
 			keyAssign.action = [this]() {
-				usePtt = !usePtt;
+				engine.togglePushToTalk();
 			};
 		}
 		const std::string pttToggleHotkeyLabel = std::format("Push-to-talk toggle: {}.", getHotkeyName(pttToggleHotkey));
 		ImGui::Text(pttToggleHotkeyLabel.c_str());
 
+		ImGui::Text("Delay before playing");
+		ImGui::SetNextItemWidth(selectablesWidth);
+		bool timingChanged = ImGui::SliderInt("##pttPreRoll", &pttPreRoll, 0, 500, "%d ms", ImGuiSliderFlags_AlwaysClamp);
+		ImGui::Text("Hold after playing");
+		ImGui::SetNextItemWidth(selectablesWidth);
+		timingChanged |= ImGui::SliderInt("##pttTail", &pttTail, 0, 1000, "%d ms", ImGuiSliderFlags_AlwaysClamp);
+		if (timingChanged) {
+			engine.setPushToTalkTiming(pttPreRoll, pttTail);
+			settingsWriter.markDirty();
+		}
+
 		ImGui::NewLine();
 		ImGui::Text("Theme");
 		if (ImGui::Combo("##theme", &theme, "Light\0Dark\0ImGUI Dark\0ImGUI Light")) {
 			setTheme();
+			settingsWriter.markDirty();
 		}
 		ImGui::NewLine();
 
@@ -506,9 +626,12 @@ namespace vi {
 			} else {
 				app->tray.reset();
 			}
+			settingsWriter.markDirty();
 		}
 		ImGui::BeginDisabled(!minimizeToTray);
-		ImGui::Checkbox("Start minimized", &startMinimized);
+		if (ImGui::Checkbox("Start minimized", &startMinimized)) {
+			settingsWriter.markDirty();
+		}
 		ImGui::EndDisabled();
 
 		if (ImGui::Checkbox("Open on startup", &openOnStartup)) {
@@ -529,12 +652,91 @@ namespace vi {
 		if (ImGui::Button("Show welcome screen", buttonSize)) {
 			showWelcome = true;
 			loadExampleSoundboard();
+			settingsWriter.markDirty();
+		}
+		ImGui::NewLine();
+
+		if (ImGui::Checkbox("Compact settings file", &compactSettings)) {
+			saveSettings();
+		}
+		ImGui::PushStyleColor(ImGuiCol_Text, textCol);
+		ImGui::Text("Loads faster with large libraries. A settings.json that is newer than the compact file is imported on launch, so it can still be edited by hand.");
+		ImGui::PopStyleColor();
+		ImGui::BeginDisabled(!compactSettings);
+		if (ImGui::Button("Export settings.json", buttonSize)) {
+			settingsWriter.write(settingsPath, [settings = snapshotSettings()]() {
+				return serializeSettings(settings, SettingsFormat::Json);
+			});
+		}
+		ImGui::EndDisabled();
+		ImGui::NewLine();
+
+		updateMemoryStats();
+		constexpr double megabyte = 1024 * 1024;
+		ImGui::Text("Memory");
+		ImGui::PushStyleColor(ImGuiCol_Text, textCol);
+		ImGui::Text("Decoded sounds take %.1f MB, in %.1f MB of slabs and buffers. Sharing identical files saves %.1f MB. Fonts take %.1f MB.",
+			static_cast<double>(memoryStats.samples) / megabyte, static_cast<double>(memoryStats.reserved) / megabyte,
+			static_cast<double>(memoryStats.shared) / megabyte, static_cast<double>(memoryStats.fonts) / megabyte);
+		for (const auto& [name, size] : memoryStats.boards) {
+			ImGui::BulletText("%s: %.1f MB", name.c_str(), static_cast<double>(size) / megabyte);
+		}
+		ImGui::PopStyleColor();
+
+		ImGui::Text("Memory budget");
+		ImGui::SetNextItemWidth(selectablesWidth);
+		if (ImGui::InputInt("##memoryBudget", &memoryBudget, 64, 256)) {
+			memoryBudget = std::clamp(memoryBudget, 0, Settings::maxMemoryBudget);
+			applyMemoryBudget(memoryBudget);
+			settingsWriter.markDirty();
+		}
+		ImGui::PushStyleColor(ImGuiCol_Text, textCol);
+		ImGui::Text("In MB, or 0 for no limit. Sounds that would go over it fail to load until others are removed. Nothing already loaded is dropped.");
+		ImGui::PopStyleColor();
+		ImGui::NewLine();
+
+		ImGui::Text("Output diagnostics");
+		ImGui::PushStyleColor(ImGuiCol_Text, textCol);
+		for (size_t i = 0; i < (dualPlayback ? 2 : 1); i++) {
+			showOutputStats(i);
+		}
+		ImGui::PopStyleColor();
+		if (ImGui::Button("Copy diagnostics", buttonSize)) {
+			SDL_SetClipboardText(formatOutputStats().c_str());
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Reset diagnostics", ImGui::GetItemRectSize())) {
+			engine.resetStats();
 		}
 
 		ImGui::End();
 	}
 
+	void MainState::showOutputStats(size_t index) noexcept {
+		const Mixer::Stats stats = engine.getStats(index);
+		if (stats.callbacks == 0) {
+			ImGui::Text("Output %d has not played anything yet.", static_cast<int>(index + 1));
+			return;
+		}
+		ImGui::Text("Output %d: %u frame buffer (%.1f ms), %llu callbacks, %llu underruns.", static_cast<int>(index + 1), stats.periodFrames,
+			static_cast<double>(stats.periodFrames) * 1000 / mixSpec.freq, static_cast<unsigned long long>(stats.callbacks),
+			static_cast<unsigned long long>(stats.xruns));
+		ImGui::Text("99%% of callbacks mixed in under %llu us (all under %llu us), came under %.1f ms apart and found under %llu frames queued.",
+			static_cast<unsigned long long>(Histogram::getPercentile(stats.renderTime, 0.99)),
+			static_cast<unsigned long long>(Histogram::getPercentile(stats.renderTime, 1.0)),
+			static_cast<double>(Histogram::getPercentile(stats.interval, 0.99)) / 1000,
+			static_cast<unsigned long long>(Histogram::getPercentile(stats.queued, 0.99)));
+	}
+
 	void MainState::showKeyAssign() noexcept {
+		const HotkeyId* const target = getKeyAssignTarget();
+		if (!target) {
+			// The sound was removed while the menu was open.
+			keyAssign.showMenu = false;
+			keyAssign.assigning = false;
+			return;
+		}
+
 		ImGui::OpenPopup("Assign a Hotkey");
 		if (ImGui::BeginPopupModal("Assign a Hotkey", &keyAssign.showMenu, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoSavedSettings)) {
 			ImGui::Text("You can assign a keybind to trigger a button even when the program is minimized.");
@@ -543,14 +745,13 @@ namespace vi {
 			if (!keyAssign.assigning) {
 				ImGui::PushFont(app->fonts[3]);
 
-				assert(keyAssign.id);
-				const std::string name = getHotkeyName(*keyAssign.id);
+				const std::string name = getHotkeyName(*target);
 				ImGui::Text("%s", name.c_str());
 
 				ImGui::PopFont();
 #ifdef VI_PLATFORM_WINDOWS
-				if (isValidHotkey(*keyAssign.id)) {
-					const Hotkey& hotkey = getHotkey(*keyAssign.id);
+				if (isValidHotkey(*target)) {
+					const Hotkey& hotkey = getHotkey(*target);
 					if ((hotkey.scancode == SDL_SCANCODE_NUMLOCKCLEAR || hotkey.scancode == SDL_SCANCODE_SCROLLLOCK) && (hotkey.mod & ~SDL_KMOD_NUM) != SDL_KMOD_NONE) {
 						ImGui::TextColored(ImVec4(0.8f, 0.1f, 0.1f, 1.0f), "Current hotkey may not behave as expected due to system behaviour.");
 					}
@@ -624,16 +825,22 @@ namespace vi {
 	}
 
 	void MainState::showSoundVolumeMenu() noexcept {
-		Sound& sound = soundboards[soundVolumeMenu.board].sounds[soundVolumeMenu.sound];
+		Sound* const found = sounds.get(soundVolumeMenu.sound);
+		if (!found) {
+			soundVolumeMenu.showMenu = false;
+			return;
+		}
+
+		Sound& sound = *found;
 		ImGui::OpenPopup("Sound Volume (Gain)");
 		if (ImGui::BeginPopupModal("Sound Volume (Gain)", &soundVolumeMenu.showMenu, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoSavedSettings)) {
 			const std::string soundName = sound.getPath().filename().string();
 			ImGui::Text("Set a custom volume for %s.", soundName.c_str());
 			ImGui::NewLine();
 
-			showGainOverrideSlider(sound, 0);
+			showGainOverrideSlider(soundVolumeMenu.sound, 0);
 			if (dualPlayback) {
-				showGainOverrideSlider(sound, 1);
+				showGainOverrideSlider(soundVolumeMenu.sound, 1);
 			}
 			ImGui::NewLine();
 
@@ -646,6 +853,9 @@ namespace vi {
 
 	void MainState::showWelcomeScreen() noexcept {
 		ImGui::Begin("Welcome", &showWelcome);
+		if (!showWelcome) {
+			settingsWriter.markDirty();
+		}
 		ImGui::PushTextWrapPos(ImGui::GetWindowWidth() - 16.0f);
 
 		ImGui::PushFont(app->fonts[2]);
@@ -715,238 +925,542 @@ namespace vi {
 		ImGui::End();
 	}
 
-	void MainState::showGainOverrideSlider(Sound& sound, size_t index) noexcept {
-		GainOverride gain = sound.getGainOverride(index);
-		ImGui::Checkbox(std::format("Output {}", index + 1).c_str(), &gain.use);
+	void MainState::showGainOverrideSlider(SoundHandle handle, size_t index) noexcept {
+		GainOverride gain = soundPlayback.getGains(handle)[index];
+		bool changed = ImGui::Checkbox(std::format("Output {}", index + 1).c_str(), &gain.use);
 		ImGui::BeginDisabled(!gain.use);
 
 		ImGui::PushID(static_cast<int>(index));
-		ImGui::SliderFloat("##gainOverrideSlider", &gain.gain, 0.0f, 2.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp);
+		changed |= ImGui::SliderFloat("##gainOverrideSlider", &gain.gain, 0.0f, 2.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp);
 		ImGui::PopID();
 
 		ImGui::EndDisabled();
-		sound.setGainOverride(index, gain);
+
+		if (changed) {
+			std::lock_guard lock(libraryMutex);
+			soundPlayback.setGain(handle, index, gain);
+			settingsWriter.markDirty();
+		}
 	}
 
-	void MainState::tryPlay(const Sound& sound) noexcept {
-		const bool playDual = dualPlayback && playback[0].deviceIndex != playback[1].deviceIndex;
+	void MainState::updateOutputs() noexcept {
+		for (size_t i = 0; i < playback.size(); i++) {
+			const PlaybackConfig& config = playback[i];
+			const bool valid = config.deviceIndex >= 0 && config.deviceIndex < static_cast<int>(audioDevices.size());
+			engine.setOutput(i, valid ? audioDevices[config.deviceIndex] : 0, config.gain);
+		}
+		engine.setDualPlayback(dualPlayback);
+	}
 
-		playback[0].stream.reset(SDL_OpenAudioDeviceStream(audioDevices[playback[0].deviceIndex], nullptr, nullptr, nullptr));
-		SDL_SetAudioStreamGain(playback[0].stream.get(), playback[0].gain);
-		if (playDual) {
-			playback[1].stream.reset(SDL_OpenAudioDeviceStream(audioDevices[playback[1].deviceIndex], nullptr, nullptr, nullptr));
-			SDL_SetAudioStreamGain(playback[1].stream.get(), playback[1].gain);
+	std::string MainState::playSound(SoundHandle handle, Uint64 triggerTime) noexcept {
+		std::shared_ptr<LazySamples> samples;
+		SoundGains gains;
+		{
+			std::lock_guard lock(libraryMutex);
+			if (!sounds.contains(handle)) {
+				return {};
+			}
+			samples = soundPlayback.shareSamples(handle);
+			gains = soundPlayback.getGains(handle);
 		}
 
+		// Decodes the sound first if it has not been played yet, outside the lock so the library stays usable meanwhile.
 		try {
-			sound.play(playback[0].stream.get(), 0);
-			if (playDual) {
-				sound.play(playback[1].stream.get(), 1);
-			}
-			if (pttScancode != SDL_SCANCODE_UNKNOWN && usePtt) {
-				app->canSleep = false;
-			}
+			engine.play(*samples, gains, triggerTime);
 		} catch (const std::exception& e) {
-			const std::string message = std::format(
-				"Unable to play sound \"{}\".\n"
-				"Please ensure the sound is in correct format or try a different playback device.\n\n"
-				"Error: {}",
-				sound.getPath().filename().string(),
-				e.what()
-			);
+			return e.what();
+		}
+		return {};
+	}
+
+	void MainState::reportPlayError(SoundHandle handle, const char* error) noexcept {
+		std::string message;
+		{
+			std::lock_guard lock(libraryMutex);
+			const Sound* sound = sounds.get(handle);
+			if (!sound) {
+				return; // Removed since, so there is nothing left to play.
+			}
+			message = getPlayErrorMessage(*sound, error);
+		}
 
-			SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Failed to play sound!", message.c_str(), app->getWindow());
+		// Shown by the main thread, as a message box elsewhere would block that thread until it is closed.
+		{
+			std::lock_guard lock(playErrorMutex);
+			playErrors.push_back(std::move(message));
 		}
+		SDL_Event event{};
+		event.user.type = getPlayErrorEventType();
+		SDL_PushEvent(&event);
+		wakeUpEventLoop();
 	}
 
-	void MainState::stop() noexcept {
-		for (PlaybackConfig& config : playback) {
-			config.stream.reset();
+	void MainState::tryPlay(SoundHandle handle) noexcept {
+		if (const std::string error = playSound(handle, 0); !error.empty()) {
+			app->showError("Failed to play sound!", getPlayErrorMessage(sounds[handle], error.c_str()));
 		}
 	}
 
-	void MainState::serialize() {
-		using namespace nlohmann;
-		json file;
+	void MainState::playFromHotkey(SoundHandle handle) noexcept {
+		if (const std::string error = playSound(handle, getHotkeyPressTime()); !error.empty()) {
+			reportPlayError(handle, error.c_str());
+		}
+	}
 
-		file["showWelcome"] = showWelcome;
+	std::string MainState::onControlCommand(std::string_view command) {
+		const Uint64 received = SDL_GetTicksNS();
+		std::vector<std::string_view> args = splitArguments(command);
+		const auto ok = [received](std::string data = {}) {
+			return std::format("{}ok {} {}\n", data, received, SDL_GetTicksNS());
+		};
 
-		json& boardArray = file["soundboards"];
-		for (const Soundboard& board : soundboards) {
-			json& boardJson = boardArray.emplace_back();
-			boardJson["path"] = board.path;
+		if (args[0] == "ping" && args.size() == 1) {
+			return ok();
+		}
 
-			json& soundsMap = boardJson["sounds"];
-			for (const Sound& sound : board.sounds) {
-				json& soundJson = soundsMap[sound.getPath().string()];
+		if (args[0] == "play" && args.size() >= 2) {
+			SoundHandle found;
+			{
+				std::lock_guard lock(libraryMutex);
+				const Sound* sound = nullptr;
 
-				for (size_t i = 0; i < playback.size(); i++) {
-					soundJson["gains"].emplace_back(sound.getGainOverride(i));
+				SoundHandle handle;
+				if (args.size() == 2 && parseId(args[1], handle)) {
+					sound = sounds.get(handle);
+				} else {
+					// Everything after the command, so names may contain spaces.
+					sound = findSound(soundboards, sounds, command.substr(args[1].data() - command.data()));
 				}
 
-				if (isValidHotkey(*sound.getHotkeyId())) {
-					soundJson["hotkey"] = serializeHotkey(*sound.getHotkeyId());
-				} else {
-					soundJson["hotkey"] = nullptr;
+				if (!sound) {
+					return "err no such sound\n";
 				}
+				found = sounds.getHandle(*sound);
+			}
+
+			if (const std::string error = playSound(found, received); !error.empty()) {
+				return std::format("err {}\n", error);
 			}
+			return ok();
 		}
 
-		for (const PlaybackConfig& config : playback) {
-			json& configJson = file["playback"].emplace_back();
-			configJson["preferred"] = config.preferred;
-			configJson["gain"] = config.gain;
+		if (args[0] == "stop" && args.size() == 1) {
+			engine.stop();
+			return ok();
 		}
-		file["dualPlayback"] = dualPlayback;
 
-		if (isValidHotkey(stopHotkey)) {
-			file["stopHotkey"] = serializeHotkey(stopHotkey);
-		} else {
-			file["stopHotkey"] = nullptr;
+		if (args[0] == "gain" && args.size() == 3) {
+			size_t output = 0;
+			float gain = 0.0f;
+			if (!parseArgument(args[1], output) || output >= playback.size()) {
+				return "err invalid output\n";
+			}
+			if (!parseArgument(args[2], gain) || gain < 0.0f || gain > 2.0f) {
+				return "err gain must be between 0 and 2\n";
+			}
+			engine.setGain(output, gain);
+			settingsWriter.markDirty();
+			return ok();
 		}
-		file["theme"] = theme;
 
-		file["minimizeToTray"] = minimizeToTray;
-		file["startMinimized"] = startMinimized;
+		if (args[0] == "memory" && args.size() == 1) {
+			std::string data = std::format("memory pcm {} budget {} fonts {}\n", getPcmMemory(), getPcmBudget(), app->fontMemory.load(std::memory_order_relaxed));
+			std::lock_guard lock(libraryMutex);
+			for (const Soundboard& board : soundboards) {
+				const std::string boardId = formatId(soundboards.getHandle(board));
+				data += std::format("board {} {}\n", boardId, getBoardMemory(board));
+				for (const SoundHandle handle : board.sounds) {
+					const std::shared_ptr<const SampleBuffer> samples = soundPlayback.getSamples(handle).get();
+					data += std::format("sound {} {} {}\n", boardId, formatId(handle), samples ? samples->getSize() : 0);
+				}
+			}
+			return ok(std::move(data));
+		}
 
-		file["pttScancode"] = pttScancode;
-		file["pttRaw"] = pttRaw;
-		file["usePtt"] = usePtt;
-		file["pttToggleHotkey"] = serializeHotkey(pttToggleHotkey);
+		if (args[0] == "stats" && args.size() == 1) {
+			return ok(formatOutputStats());
+		}
 
-		const bool maximized = SDL_GetWindowFlags(app->getWindow()) & SDL_WINDOW_MAXIMIZED;
-		file["maximized"] = maximized;
-		if (!maximized) {
-			SDL_Rect windowBounds;
-			if (SDL_GetWindowPosition(app->getWindow(), &windowBounds.x, &windowBounds.y)) {
-				file["windowX"] = windowBounds.x;
-				file["windowY"] = windowBounds.y;
+		if (args[0] == "list" && args.size() == 1) {
+			std::string data;
+			std::lock_guard lock(libraryMutex);
+			for (const Soundboard& board : soundboards) {
+				const std::string boardId = formatId(soundboards.getHandle(board));
+				data += std::format("board {} {}\n", boardId, board.path.string());
+				for (const SoundHandle handle : board.sounds) {
+					data += std::format("sound {} {} {}\n", boardId, formatId(handle), sounds[handle].getPath().filename().string());
+				}
 			}
-			if (SDL_GetWindowSize(app->getWindow(), &windowBounds.w, &windowBounds.h)) {
-				file["windowWidth"] = windowBounds.w;
-				file["windowHeight"] = windowBounds.h;
+			return ok(std::move(data));
+		}
+
+		return "err unknown command\n";
+	}
+
+	Settings MainState::snapshotSettings() {
+		Settings settings;
+		settings.showWelcome = showWelcome;
+
+		const auto getBinding = [](HotkeyId id) -> std::optional<HotkeyBinding> {
+			if (!isValidHotkey(id)) {
+				return std::nullopt;
+			}
+			const Hotkey& hotkey = getHotkey(id);
+			return HotkeyBinding{hotkey.scancode, hotkey.raw, hotkey.mod};
+		};
+
+		settings.soundboards.reserve(soundboards.size());
+		for (const Soundboard& board : soundboards) {
+			SoundboardSettings& boardSettings = settings.soundboards.emplace_back();
+			boardSettings.path = board.path;
+			boardSettings.sounds.reserve(board.sounds.size());
+
+			for (const SoundHandle handle : board.sounds) {
+				const Sound& sound = sounds[handle];
+				SoundSettings& soundSettings = boardSettings.sounds.emplace_back();
+				soundSettings.path = sound.getPath();
+				soundSettings.info = sound.getInfo();
+				soundSettings.gains = soundPlayback.getGains(handle);
+				soundSettings.hotkey = getBinding(*sound.getHotkeyId());
 			}
-		} else {
-			file["windowX"] = 0;
-			file["windowY"] = 0;
-			file["windowWidth"] = 0;
-			file["windowHeight"] = 0;
 		}
 
-		std::ofstream stream(settingsPath, std::ofstream::trunc);
-		stream << file;
-		if (!stream) {
-			throw IOError("File stream in error state after write.");
+		for (size_t i = 0; i < playback.size(); i++) {
+			settings.playback[i].preferred = playback[i].preferred;
+			settings.playback[i].gain = engine.getGain(i);
+		}
+		settings.dualPlayback = dualPlayback;
+		settings.stopHotkey = getBinding(stopHotkey);
+		settings.theme = theme;
+
+		settings.minimizeToTray = minimizeToTray;
+		settings.startMinimized = startMinimized;
+
+		settings.pttScancode = pttScancode;
+		settings.pttRaw = pttRaw;
+		settings.usePtt = engine.isPushToTalkEnabled();
+		settings.pttPreRoll = pttPreRoll;
+		settings.pttTail = pttTail;
+		settings.pttToggleHotkey = getBinding(pttToggleHotkey);
+
+		if (guiInitialized) {
+			maximized = SDL_GetWindowFlags(app->getWindow()) & SDL_WINDOW_MAXIMIZED;
+			if (maximized) {
+				windowBounds = {0, 0, 0, 0};
+			} else {
+				SDL_GetWindowPosition(app->getWindow(), &windowBounds.x, &windowBounds.y);
+				SDL_GetWindowSize(app->getWindow(), &windowBounds.w, &windowBounds.h);
+			}
 		}
+		settings.maximized = maximized;
+		settings.windowBounds = windowBounds;
+		settings.compactSettings = compactSettings;
+		settings.memoryBudget = memoryBudget;
+		return settings;
 	}
 
-	void MainState::deserialize() {
-		using namespace nlohmann;
-		std::ifstream stream(settingsPath);
+	void MainState::saveSettings() {
+		// Only the snapshot is taken here. Serializing and writing it happen on the writer's thread.
+		settingsWriter.write(getSettingsPath(), [settings = snapshotSettings(), format = getSettingsFormat()]() {
+			return serializeSettings(settings, format);
+		});
+	}
 
-		json file;
-		stream >> file;
-		if (!stream) {
+	fs::path MainState::getSettingsPath() const noexcept {
+		return compactSettings ? compactSettingsPath : settingsPath;
+	}
+
+	void MainState::deserialize() {
+		// Whichever file was written last wins, so a hand-edited settings.json is imported over the compact one.
+		std::error_code error;
+		const auto jsonTime = fs::last_write_time(settingsPath, error);
+		const bool hasJson = !error;
+		const auto compactTime = fs::last_write_time(compactSettingsPath, error);
+		const bool useCompact = !error && (!hasJson || compactTime > jsonTime);
+
+		std::ifstream stream(useCompact ? compactSettingsPath : settingsPath, std::ios::binary);
+		const std::string data{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+		if (!stream && !stream.eof()) {
 			throw IOError("Stream in error state after read.");
 		}
 
-		file.at("showWelcome").get_to(showWelcome);
+		applySettings(parseSettings(data, useCompact ? SettingsFormat::MessagePack : SettingsFormat::Json));
+	}
 
-		for (const json& boardJson : file.at("soundboards")) {
-			fs::path boardPath = boardJson.at("path").get<fs::path>();
-			if (!fs::exists(boardPath)) {
-				soundboards.emplace_back(std::move(boardPath));
-				continue;
+	void MainState::applySettings(const Settings& settings) {
+		showWelcome = settings.showWelcome;
+		// Before any board, so the loader never decodes past it.
+		memoryBudget = std::clamp(settings.memoryBudget, 0, Settings::maxMemoryBudget);
+		applyMemoryBudget(memoryBudget);
+
+		const auto registerBinding = [this](const std::optional<HotkeyBinding>& binding, std::function<void()> callback) {
+			if (!binding) {
+				return nullHotkey;
+			}
+			Hotkey hotkey;
+			hotkey.scancode = binding->scancode;
+			hotkey.raw = binding->raw;
+			hotkey.mod = binding->mod;
+			hotkey.callback = std::move(callback);
+			return tryRegisterHotkey(hotkey, *app);
+		};
+
+		// Built from the manifest alone. The loader checks each board against its folder and decodes it afterwards.
+		for (const SoundboardSettings& boardSettings : settings.soundboards) {
+			auto arena = std::make_shared<PcmArena>();
+			std::vector<Sound> boardSounds;
+			boardSounds.reserve(boardSettings.sounds.size());
+			for (const SoundSettings& soundSettings : boardSettings.sounds) {
+				boardSounds.emplace_back(soundSettings.path, soundSettings.info, arena);
 			}
 
-			const std::string pathStr = boardPath.string();
-			const char* pathCStr = pathStr.c_str();
+			const Soundboard& board = addSoundboard(boardSettings.path, std::move(arena), std::move(boardSounds));
+			{
+				std::lock_guard lock(libraryMutex);
+				for (size_t i = 0; i < board.sounds.size(); i++) {
+					for (size_t j = 0; j < playback.size(); j++) {
+						soundPlayback.setGain(board.sounds[i], j, boardSettings.sounds[i].gains[j]);
+					}
+				}
+			}
+			for (size_t i = 0; i < board.sounds.size(); i++) {
+				const SoundHandle handle = board.sounds[i];
+				*sounds[handle].getHotkeyId() = registerBinding(boardSettings.sounds[i].hotkey, [this, handle]() {
+					playFromHotkey(handle);
+				});
+			}
+			syncSoundboard(board);
+		}
 
-			browseFiles(&browseData, &pathCStr, 0);
-			soundboards.push_back(std::move(browseData.result));
-			browseData.ready = false;
+		for (size_t i = 0; i < playback.size(); i++) {
+			playback[i].preferred = settings.playback[i].preferred;
+			playback[i].gain = settings.playback[i].gain;
+		}
 
-			for (size_t i = 0; i < soundboards.back().sounds.size(); i++) {
-				Sound& sound = soundboards.back().sounds[i];
+		dualPlayback = settings.dualPlayback;
+		stopHotkey = registerBinding(settings.stopHotkey, [this]() {
+			engine.stop();
+		});
+		theme = settings.theme;
+
+		minimizeToTray = settings.minimizeToTray;
+		startMinimized = settings.startMinimized;
+
+		pttScancode = settings.pttScancode;
+		pttRaw = settings.pttRaw;
+		engine.setPushToTalkKey(pttScancode, pttRaw);
+		engine.setPushToTalkEnabled(settings.usePtt);
+		pttPreRoll = settings.pttPreRoll;
+		pttTail = settings.pttTail;
+		pttToggleHotkey = registerBinding(settings.pttToggleHotkey, [this]() {
+			engine.togglePushToTalk();
+		});
+
+		maximized = settings.maximized;
+		windowBounds = settings.windowBounds;
+		compactSettings = settings.compactSettings;
+	}
 
-				const json& soundsJson = boardJson.at("sounds");
-				const auto it = soundsJson.find(sound.getPath());
-				if (it == soundsJson.end()) {
-					continue;
+	void MainState::applyLoadResults() {
+		for (SoundLoader::Result& result : soundLoader.takeResults()) {
+			const auto board = std::find_if(soundboards.begin(), soundboards.end(), [&result](const Soundboard& board) {
+				return board.path == result.board;
+			});
+			if (board == soundboards.end()) {
+				// Closed since it was queued.
+				continue;
+			}
+			if (result.rescan) {
+				syncSoundboard(*board);
+				continue;
+			}
+
+			if (!result.errors.empty()) {
+				std::string message = std::format(
+					"Unable to load some sounds from \"{}\".\n"
+					"Please ensure that the files are in correct format and that the program has read permission for that directory.\n",
+					board->path.filename().string()
+				);
+				for (const std::string& error : result.errors) {
+					message += "\n" + error;
 				}
+				app->showError("Failed to load sound!", message);
+			}
+			if (result.added.empty() && result.removed.empty() && result.updated.empty()) {
+				continue;
+			}
+
+			std::unordered_set<fs::path> removedPaths(result.removed.begin(), result.removed.end());
+			std::unordered_map<fs::path, SoundHandle> byPath;
+			// Removed sounds by content, so a renamed file keeps its hotkey, gains and place.
+			std::unordered_map<uint64_t, SoundHandle> removedByHash;
+			byPath.reserve(board->sounds.size());
+			for (const SoundHandle handle : board->sounds) {
+				const Sound& sound = sounds[handle];
+				byPath.emplace(sound.getPath(), handle);
+				if (removedPaths.contains(sound.getPath()) && sound.getInfo().isKnown()) {
+					removedByHash.emplace(sound.getInfo().hash, handle);
+				}
+			}
 
-				for (size_t i = 0; i < playback.size(); i++) {
-					sound.setGainOverride(i, it->at("gains")[i].get<GainOverride>());
+			std::lock_guard lock(libraryMutex);
+			for (const auto& [path, info] : result.updated) {
+				if (const auto it = byPath.find(path); it != byPath.end()) {
+					sounds[it->second].setInfo(info);
 				}
+			}
 
-				if (!it->at("hotkey").is_null()) {
-					Hotkey hotkey = deserializeHotkey(it->at("hotkey"));
-					const size_t soundboardIndex = soundboards.size() - 1;
-					hotkey.callback = [this, i, soundboardIndex]() {
-						tryPlay(soundboards[soundboardIndex].sounds[i]);
-					};
-					*sound.getHotkeyId() = tryRegisterHotkey(hotkey, app->getWindow());
+			for (Sound& sound : result.added) {
+				if (const auto it = byPath.find(sound.getPath()); it != byPath.end()) {
+					sounds[it->second].assignFile(std::move(sound));
+					soundPlayback.setSamples(it->second, sounds[it->second].getLazySamples());
+				} else if (const auto renamed = removedByHash.find(sound.getInfo().hash); renamed != removedByHash.end()) {
+					Sound& original = sounds[renamed->second];
+					removedPaths.erase(original.getPath());
+					original.assignFile(std::move(sound));
+					soundPlayback.setSamples(renamed->second, original.getLazySamples());
+					removedByHash.erase(renamed);
+				} else {
+					board->sounds.push_back(insertSound(std::move(sound)));
 				}
 			}
+
+			std::erase_if(board->sounds, [this, &removedPaths](SoundHandle handle) {
+				if (!removedPaths.contains(sounds[handle].getPath())) {
+					return false;
+				}
+				eraseSound(handle);
+				return true;
+			});
+			// Replaced and removed samples leave holes in the board's slabs.
+			soundLoader.compact(getBoardSounds(*board));
+			settingsWriter.markDirty();
 		}
+	}
 
-		for (size_t i = 0; i < playback.size(); i++) {
-			PlaybackConfig& config = playback[i];
-			const json& configJson = file.at("playback").at(i);
+	void MainState::updateMemoryStats() noexcept {
+		const Uint64 now = SDL_GetTicks();
+		if (memoryStatsTime != 0 && now - memoryStatsTime < 1000) {
+			return;
+		}
+		memoryStatsTime = now;
 
-			configJson.at("preferred").get_to(config.preferred);
+		memoryStats = {};
+		memoryStats.reserved = getPcmMemory();
+		memoryStats.fonts = app->fontMemory.load(std::memory_order_relaxed);
+		for (const Soundboard& board : soundboards) {
+			memoryStats.boards.emplace_back(board.path.filename().string(), getBoardMemory(board));
+		}
 
-			const float gain = configJson.at("gain").get<float>();
-			if (gain < 0.0f || gain > 2.0f) {
-				throw IOError("Bad gain.");
+		std::unordered_set<const SampleBuffer*> counted;
+		for (const std::shared_ptr<LazySamples>& lazySamples : soundPlayback.getAllSamples()) {
+			const std::shared_ptr<const SampleBuffer> samples = lazySamples ? lazySamples->get() : nullptr;
+			if (!samples) {
+				continue;
+			}
+			if (counted.insert(samples.get()).second) {
+				memoryStats.samples += samples->getSize();
+			} else {
+				memoryStats.shared += samples->getSize();
 			}
-			config.gain = gain;
 		}
+	}
 
-		file.at("dualPlayback").get_to(dualPlayback);
-		if (!file.at("stopHotkey").is_null()) {
-			Hotkey hotkey = deserializeHotkey(file["stopHotkey"]);
-			hotkey.callback = [this]() {
-				stop();
-			};
-			stopHotkey = tryRegisterHotkey(hotkey, app->getWindow());
+	size_t MainState::getBoardMemory(const Soundboard& board) const {
+		size_t size = 0;
+		std::unordered_set<const SampleBuffer*> counted;
+		for (const SoundHandle handle : board.sounds) {
+			const std::shared_ptr<const SampleBuffer> samples = soundPlayback.getSamples(handle).get();
+			if (samples && counted.insert(samples.get()).second) {
+				size += samples->getSize();
+			}
 		}
+		return size;
+	}
 
-		const int theme = file["theme"].get<int>();
-		if (theme < 0 || theme > 3) {
-			throw IOError("Bad theme.");
+	std::string MainState::formatOutputStats() const {
+		const auto formatCounts = [](const Histogram::Counts& counts) {
+			std::string string;
+			for (const uint64_t count : counts) {
+				string += std::format(" {}", count);
+			}
+			return string;
+		};
+
+		std::string data;
+		for (size_t i = 0; i < playback.size(); i++) {
+			const Mixer::Stats stats = engine.getStats(i);
+			data += std::format("output {} period {} callbacks {} xruns {}\n", i, stats.periodFrames, stats.callbacks, stats.xruns);
+			data += std::format("render {}{}\n", i, formatCounts(stats.renderTime));
+			data += std::format("interval {}{}\n", i, formatCounts(stats.interval));
+			data += std::format("queued {}{}\n", i, formatCounts(stats.queued));
 		}
-		this->theme = theme;
+		return data;
+	}
 
-		file.at("minimizeToTray").get_to(minimizeToTray);
-		file.at("startMinimized").get_to(startMinimized);
+	SoundHandle MainState::insertSound(Sound sound) {
+		std::shared_ptr<LazySamples> samples = sound.getLazySamples();
+		const SoundHandle handle = sounds.insert(std::move(sound));
+		soundPlayback.assign(handle, std::move(samples));
+		return handle;
+	}
+
+	void MainState::eraseSound(SoundHandle handle) noexcept {
+		soundPlayback.release(handle);
+		sounds.erase(handle);
+	}
 
-		file.at("pttScancode").get_to(pttScancode);
-		file.at("pttRaw").get_to(pttRaw);
-		file.at("usePtt").get_to(usePtt);
+	Soundboard& MainState::addSoundboard(fs::path path, std::shared_ptr<PcmArena> arena, std::vector<Sound> boardSounds) {
+		watchDirectory(path);
 
-		if (!file.at("pttToggleHotkey").is_null()) {
-			Hotkey hotkey = deserializeHotkey(file["pttToggleHotkey"]);
-			hotkey.callback = [this]() {
-				usePtt = !usePtt;
-			};
-			pttToggleHotkey = tryRegisterHotkey(hotkey, app->getWindow());
+		Soundboard board{std::move(path), {}, std::move(arena)};
+		board.sounds.reserve(boardSounds.size());
+		std::lock_guard lock(libraryMutex);
+		for (Sound& sound : boardSounds) {
+			board.sounds.push_back(insertSound(std::move(sound)));
 		}
+		return soundboards[soundboards.insert(std::move(board))];
+	}
 
-		if (file.at("maximized").get<bool>()) {
-			SDL_MaximizeWindow(app->getWindow());
-		} else {
-			SDL_Rect windowBounds;
-			file.at("windowX").get_to(windowBounds.x);
-			file.at("windowY").get_to(windowBounds.y);
-			file.at("windowWidth").get_to(windowBounds.w);
-			file.at("windowHeight").get_to(windowBounds.h);
+	void MainState::removeSoundboard(SoundboardHandle handle) {
+		const fs::path path = soundboards[handle].path;
+		{
+			std::lock_guard lock(libraryMutex);
+			for (const SoundHandle sound : soundboards[handle].sounds) {
+				eraseSound(sound);
+			}
+			soundboards.erase(handle);
+		}
 
-			SDL_SetWindowPosition(app->getWindow(), windowBounds.x, windowBounds.y);
-			SDL_SetWindowSize(app->getWindow(), windowBounds.w, windowBounds.h);
+		const bool watchedElsewhere = std::any_of(soundboards.begin(), soundboards.end(), [&path](const Soundboard& board) {
+			return board.path == path;
+		});
+		if (!watchedElsewhere) {
+			unwatchDirectory(path);
 		}
 	}
 
+	void MainState::syncSoundboard(const Soundboard& board) {
+		soundLoader.sync(board.path, board.arena, getBoardSounds(board));
+	}
+
+	std::vector<const Sound*> MainState::getBoardSounds(const Soundboard& board) const {
+		std::vector<const Sound*> boardSounds;
+		boardSounds.reserve(board.sounds.size());
+		for (const SoundHandle handle : board.sounds) {
+			boardSounds.push_back(&sounds[handle]);
+		}
+		return boardSounds;
+	}
+
+	HotkeyId* MainState::getKeyAssignTarget() noexcept {
+		if (keyAssign.id) {
+			return keyAssign.id;
+		}
+		Sound* sound = sounds.get(keyAssign.sound);
+		return sound ? sound->getHotkeyId() : nullptr;
+	}
+
 	void MainState::setTheme() const noexcept {
 		switch (theme) {
 		case 0:
@@ -987,13 +1501,13 @@ namespace vi {
 			message += error;
 		}
 
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error saving settings!", message.c_str(), app->getWindow());
+		app->showError("Error saving settings!", message);
 	}
 
 	void MainState::createTray() noexcept {
 		app->tray.reset(SDL_CreateTray(app->getTrayIcon(), VI_EXECUTEABLE_NAME));
 		if (!app->tray) {
-			SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error creating system tray", "An error has occured while trying to create a system tray icon.", app->getWindow());
+			app->showError("Error creating system tray", "An error has occured while trying to create a system tray icon.");
 			minimizeToTray = false;
 			return;
 		}
@@ -1003,10 +1517,7 @@ namespace vi {
 
 		SDL_SetTrayEntryCallback(showEntry,
 			[](void* userData, SDL_TrayEntry* entry) {
-			const Application& app = *static_cast<Application*>(userData);
-
-			SDL_ShowWindow(app.getWindow());
-			SDL_RestoreWindow(app.getWindow());
+			static_cast<Application*>(userData)->requestShow();
 		},
 			app);
 
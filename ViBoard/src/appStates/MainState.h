@@ -20,33 +20,55 @@
 
 #include "AppState.h"
 #include "../Audio.h"
+#include "../AudioEngine.h"
 #include "../platform/Hotkey.h"
 #include "../platform/Platform.h"
+#include "../platform/ControlSocket.h"
+#include "../platform/DirectoryWatcher.h"
 #include "../Application.h"
+#include "../Settings.h"
+#include "../SettingsWriter.h"
+#include "../SoundLoader.h"
+#include "../SlotMap.h"
+#include "../PlaybackTable.h"
 
 #include <SDL3/SDL.h>
 
 #include <vector>
+#include <string>
+#include <string_view>
 #include <filesystem>
 #include <format>
 #include <array>
 #include <atomic>
+#include <mutex>
 
 namespace vi {
+	// Stays valid through any change to the library, unlike an index, so hotkeys and remote clients can hold on to it.
+	// Resolves to nothing once the sound is removed.
+	using SoundHandle = Handle<Sound>;
+
 	struct Soundboard {
 		std::filesystem::path path;
-		std::vector<Sound> sounds;
+		// In display order. The sounds themselves are stored in MainState::sounds.
+		std::vector<SoundHandle> sounds;
+		// Where the board's samples are decoded to. Freed with the board, once no voice is playing from it.
+		std::shared_ptr<PcmArena> arena;
 	};
 
+	using SoundboardHandle = Handle<Soundboard>;
+
 	struct BrowseUserData {
-		SDL_Window* window = nullptr;
-		Soundboard result;
+		const Application* app = nullptr;
+		std::filesystem::path result;
 		std::atomic_bool ready = false;
 	};
 
 	struct KeybindAssign {
 		bool showMenu = false;
 		bool assigning = false;
+		// Either the sound whose hotkey is being assigned, or one of the other hotkeys.
+		SoundHandle sound;
 		HotkeyId* id = nullptr;
 		std::function<void()> action;
 	};
@@ -58,12 +80,10 @@ namespace vi {
 
 	struct SoundVolumeMenu {
 		bool showMenu = false;
-		size_t board = 0;
-		size_t sound = 0;
+		SoundHandle sound;
 	};
 
 	struct PlaybackConfig {
-		AudioStreamOwner stream{nullptr, SDL_DestroyAudioStream};
 		// Must be int for ImGUI compatibility.
 		int deviceIndex = 0;
 		// Storing a copy of the preferred device name as it may not currently be available.
@@ -71,18 +91,44 @@ namespace vi {
 		float gain = 1.0f;
 	};
 
+	// Decoded samples across the library, counting each buffer once.
+	struct MemoryStats {
+		size_t samples = 0;
+		// What identical files would have taken on top, had each been decoded separately.
+		size_t shared = 0;
+		// See getPcmMemory(). Above samples by whatever slabs have yet to be filled or compacted.
+		size_t reserved = 0;
+		size_t fonts = 0;
+		// Each board's folder name and decoded samples, with files shared within the board counted once.
+		std::vector<std::pair<std::string, size_t>> boards;
+	};
+
 	class MainState : public AppState {
 	public:
 		MainState(Application& app);
 		virtual ~MainState() noexcept;
 
+		void initGui() override;
+		bool startsHidden() const noexcept override;
 		void onEvent(const SDL_Event& event) noexcept override;
 		void update() noexcept override;
 
 	private:
 		Application* app;
-		std::vector<Soundboard> soundboards;
-		std::array<PlaybackConfig, 2> playback;
+		AudioEngine engine;
+		// Hotkey callbacks read soundboards from the hotkey thread. The main thread must hold this while modifying them,
+		// but never while registering hotkeys.
+		std::mutex libraryMutex;
+		SlotMap<Soundboard> soundboards;
+		SlotMap<Sound> sounds;
+		// Gains and samples of every sound in sounds, for playing them without touching the Sound.
+		PlaybackTable soundPlayback;
+		// Errors from playing sounds off the main thread, waiting to be shown on it.
+		std::mutex playErrorMutex;
+		std::vector<std::string> playErrors;
+		// Declared after everything its tasks touch, so it is stopped before any of that is destroyed.
+		SoundLoader soundLoader;
+		std::array<PlaybackConfig, AudioEngine::outputCount> playback;
 		bool dualPlayback = false;
 		
 		std::vector<SDL_AudioDeviceID> audioDevices;
@@ -97,17 +143,30 @@ namespace vi {
 		PushToTalkAssign pttAssign;
 		SDL_Scancode pttScancode = SDL_SCANCODE_UNKNOWN;
 		uint16_t pttRaw = 0;
-		bool pttActive = false;
-		
-		bool usePtt = false;
 		HotkeyId pttToggleHotkey = nullHotkey;
+		// In milliseconds.
+		int pttPreRoll = 80;
+		int pttTail = 200;
 
-		BrowseUserData browseData{app->getWindow()};
+		BrowseUserData browseData{app};
 		int theme = 0;
 		
+		bool guiInitialized = false;
+		// Restored once the window exists, and kept as loaded when running headless.
+		bool maximized = false;
+		SDL_Rect windowBounds{0, 0, 0, 0};
+
 		bool minimizeToTray = false;
 		bool openOnStartup = isLaunchingOnStartup();
 		bool startMinimized = false;
+		bool compactSettings = false;
+
+		SettingsWriter settingsWriter;
+
+		MemoryStats memoryStats;
+		Uint64 memoryStatsTime = 0;
+		// In MB, or 0 for no limit.
+		int memoryBudget = 0;
 
 		void showSoundboards() noexcept;
 		void showOptions() noexcept;
@@ -126,17 +185,57 @@ namespace vi {
 
 		void showGainSlider(size_t index) noexcept {
 			PlaybackConfig& config = playback[index];
+			config.gain = engine.getGain(index); // May have been changed through the control socket.
 			if (ImGui::SliderFloat(std::format("Output {}", index + 1).c_str(), &config.gain, 0.0f, 2.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp)) {
-				SDL_SetAudioStreamGain(config.stream.get(), config.gain);
+				updateOutputs();
+				settingsWriter.markDirty();
 			}
 		}
-		void showGainOverrideSlider(Sound& sound, size_t index) noexcept;
-
-		void tryPlay(const Sound& sound) noexcept;
-		void stop() noexcept;
-
-		void serialize();
+		void showGainOverrideSlider(SoundHandle handle, size_t index) noexcept;
+		void showOutputStats(size_t index) noexcept;
+
+		void updateOutputs() noexcept;
+		// Safe from any thread. Only holds libraryMutex while copying what playing needs, so decoding a sound that
+		// has not been played yet happens on the calling thread. Returns why playing failed, or nothing.
+		std::string playSound(SoundHandle handle, Uint64 triggerTime) noexcept;
+		// Has the main thread show the error. Safe from any thread that does not hold libraryMutex.
+		void reportPlayError(SoundHandle handle, const char* error) noexcept;
+		void tryPlay(SoundHandle handle) noexcept;
+		// Runs on the hotkey thread.
+		void playFromHotkey(SoundHandle handle) noexcept;
+		// Runs on the control socket thread.
+		std::string onControlCommand(std::string_view command);
+
+		// Main thread only.
+		Settings snapshotSettings();
+		void saveSettings();
 		void deserialize();
+		void applySettings(const Settings& settings);
+		void applyLoadResults();
+		// Recounted at most once a second, as samples get loaded in the background without notice.
+		void updateMemoryStats() noexcept;
+		// Expects libraryMutex to be held, or to be on the main thread.
+		size_t getBoardMemory(const Soundboard& board) const;
+		// One line per output and per histogram, as the "stats" command sends them. Safe from any thread.
+		std::string formatOutputStats() const;
+
+		// The sounds must have been created with the given arena.
+		// Both expect libraryMutex to be held.
+		SoundHandle insertSound(Sound sound);
+		void eraseSound(SoundHandle handle) noexcept;
+
+		Soundboard& addSoundboard(std::filesystem::path path, std::shared_ptr<PcmArena> arena, std::vector<Sound> boardSounds);
+		void removeSoundboard(SoundboardHandle handle);
+		// Has the loader check the board against its folder.
+		void syncSoundboard(const Soundboard& board);
+		std::vector<const Sound*> getBoardSounds(const Soundboard& board) const;
+		HotkeyId* getKeyAssignTarget() noexcept;
+
+		std::filesystem::path getSettingsPath() const noexcept;
+
+		SettingsFormat getSettingsFormat() const noexcept {
+			return compactSettings ? SettingsFormat::MessagePack : SettingsFormat::Json;
+		}
 
 		void setTheme() const noexcept;
 		void loadExampleSoundboard() noexcept;
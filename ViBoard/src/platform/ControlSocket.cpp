@@ -0,0 +1,57 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ControlSocket.h"
+
+namespace vi {
+	// Set before the endpoint starts, and only called by its thread.
+	ControlHandler controlHandler;
+
+	std::string processControlInput(std::string& buffer) {
+		std::string reply;
+		size_t start = 0;
+		for (size_t end = buffer.find('\n'); end != std::string::npos; end = buffer.find('\n', start)) {
+			std::string_view line(buffer.data() + start, end - start);
+			if (!line.empty() && line.back() == '\r') {
+				line.remove_suffix(1);
+			}
+			if (!line.empty()) {
+				reply += controlHandler(line);
+			}
+			start = end + 1;
+		}
+		buffer.erase(0, start);
+		return reply;
+	}
+
+	bool isReplyComplete(std::string_view reply, size_t commandCount) noexcept {
+		size_t count = 0;
+		for (size_t start = 0; start < reply.size();) {
+			const size_t end = reply.find('\n', start);
+			if (end == std::string_view::npos) {
+				break;
+			}
+			const std::string_view line = reply.substr(start, end - start);
+			if (line.starts_with("ok") || line.starts_with("err")) {
+				count++;
+			}
+			start = end + 1;
+		}
+		return count >= commandCount;
+	}
+}
\ No newline at end of file
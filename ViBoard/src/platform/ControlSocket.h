@@ -0,0 +1,48 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace vi {
+	// Local endpoint that other programs, such as scripts and stream decks, can drive the app through.
+	// It is a Unix domain socket on Linux and a named pipe on Windows.
+	//
+	// Commands are newline-separated text. Each command is answered in order by zero or more data lines,
+	// followed by a single line starting with "ok" or "err". Clients may send many commands at once.
+	using ControlHandler = std::function<std::string(std::string_view command)>;
+
+	// The handler is called on a dedicated thread, and must return the full reply including its final line.
+	// Returns false if the endpoint could not be created, for example because another instance owns it.
+	bool initControlSocket(ControlHandler handler);
+	void quitControlSocket() noexcept;
+
+	std::string getControlSocketPath();
+
+	// Sends newline-terminated commands to the running instance and waits for all of their replies.
+	// Returns false if no instance is listening or it stopped responding.
+	bool sendControlCommands(std::string_view commands, std::string& reply) noexcept;
+
+	// Splits buffer into complete lines, replying to each through the handler. Any incomplete line is left in buffer.
+	std::string processControlInput(std::string& buffer);
+	// Whether reply holds the final line for each of commandCount commands.
+	bool isReplyComplete(std::string_view reply, size_t commandCount) noexcept;
+}
\ No newline at end of file
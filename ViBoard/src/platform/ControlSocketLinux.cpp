@@ -0,0 +1,309 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifdef VI_PLATFORM_LINUX
+
+#include "ControlSocket.h"
+#include "../Log.h"
+#include "../Exceptions.h"
+
+#include <SDL3/SDL.h>
+
+#include <array>
+#include <algorithm>
+#include <unordered_map>
+#include <thread>
+#include <format>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+namespace vi {
+	extern ControlHandler controlHandler;
+
+	namespace {
+		// Clients that send more than this without a newline are disconnected.
+		constexpr size_t maxLineLength = 64 * 1024;
+
+		std::thread controlThread;
+		int epollFd = -1;
+		int wakeFd = -1;
+		int listenFd = -1;
+		std::string socketPath;
+
+		struct Client {
+			std::string input; // Unfinished line.
+			std::string output; // Replies the client has not taken yet.
+		};
+
+		// Only accessed by the control thread.
+		std::unordered_map<int, Client> clients;
+
+		bool addToEpoll(int fd) noexcept {
+			epoll_event event{};
+			event.events = EPOLLIN;
+			event.data.fd = fd;
+			return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+		}
+
+		sockaddr_un getAddress() noexcept {
+			sockaddr_un address{};
+			address.sun_family = AF_UNIX;
+			strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+			return address;
+		}
+
+		// A client is not read from while replies are pending, so one that never reads cannot make them grow without bound.
+		void setWaitingForOutput(int fd, bool waiting) noexcept {
+			epoll_event event{};
+			event.events = waiting ? EPOLLOUT : EPOLLIN;
+			event.data.fd = fd;
+			epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+		}
+
+		void closeClient(int fd) noexcept {
+			epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+			close(fd);
+			clients.erase(fd);
+		}
+
+		bool writeAll(int fd, std::string_view data) noexcept {
+			while (!data.empty()) {
+				const ssize_t written = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+				if (written < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					return false;
+				}
+				data.remove_prefix(static_cast<size_t>(written));
+			}
+			return true;
+		}
+
+		// Sends as much pending output as the client takes without blocking. Returns false once the client is gone.
+		bool flushClient(int fd, Client& client) noexcept {
+			while (!client.output.empty()) {
+				const ssize_t written = send(fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+				if (written < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					return errno == EAGAIN || errno == EWOULDBLOCK;
+				}
+				client.output.erase(0, static_cast<size_t>(written));
+			}
+			return true;
+		}
+
+		void acceptClients() noexcept {
+			while (true) {
+				// Non-blocking, so a client that stops reading its replies cannot stall the others.
+				const int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+				if (fd < 0) {
+					return;
+				}
+				if (!addToEpoll(fd)) {
+					close(fd);
+					continue;
+				}
+				clients.emplace(fd, Client());
+			}
+		}
+
+		void readClient(int fd) noexcept {
+			std::array<char, 4096> data;
+			const ssize_t size = recv(fd, data.data(), data.size(), 0);
+			if (size <= 0) {
+				if (size == 0 || errno != EINTR) {
+					closeClient(fd);
+				}
+				return;
+			}
+
+			Client& client = clients[fd];
+			client.input.append(data.data(), static_cast<size_t>(size));
+
+			try {
+				client.output += processControlInput(client.input);
+			} catch (const std::exception& e) {
+				client.output += std::format("err {}\n", e.what());
+				client.input.clear();
+			}
+			if (!flushClient(fd, client) || client.input.size() > maxLineLength) {
+				closeClient(fd);
+			} else if (!client.output.empty()) {
+				setWaitingForOutput(fd, true);
+			}
+		}
+
+		void writeClient(int fd) noexcept {
+			Client& client = clients[fd];
+			if (!flushClient(fd, client)) {
+				closeClient(fd);
+			} else if (client.output.empty()) {
+				setWaitingForOutput(fd, false);
+			}
+		}
+
+		void runControlThread() noexcept {
+			std::array<epoll_event, 16> ready;
+			while (true) {
+				const int count = epoll_wait(epollFd, ready.data(), static_cast<int>(ready.size()), -1);
+				if (count < 0 && errno != EINTR) {
+					VI_ERROR("epoll_wait failed: %s", strerror(errno));
+					return;
+				}
+
+				for (int i = 0; i < count; i++) {
+					const int fd = ready[i].data.fd;
+					if (fd == wakeFd) {
+						return;
+					} else if (fd == listenFd) {
+						acceptClients();
+					} else if (ready[i].events & EPOLLOUT) {
+						writeClient(fd);
+					} else {
+						readClient(fd);
+					}
+				}
+			}
+		}
+
+		bool isOwnedByOtherInstance() noexcept {
+			const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+			if (fd < 0) {
+				return false;
+			}
+			const sockaddr_un address = getAddress();
+			const bool connected = connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+			close(fd);
+			return connected;
+		}
+	}
+
+	std::string getControlSocketPath() {
+		const char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+		if (runtimeDir && *runtimeDir) {
+			return std::format("{}/{}.sock", runtimeDir, VI_EXECUTEABLE_NAME);
+		}
+		return std::format("/tmp/{}-{}.sock", VI_EXECUTEABLE_NAME, getuid());
+	}
+
+	bool sendControlCommands(std::string_view commands, std::string& reply) noexcept {
+		socketPath = getControlSocketPath();
+		const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd < 0) {
+			return false;
+		}
+
+		const timeval timeout{2, 0};
+		setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+		const sockaddr_un address = getAddress();
+		const size_t commandCount = static_cast<size_t>(std::count(commands.begin(), commands.end(), '\n'));
+		bool success = connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0 && writeAll(fd, commands);
+
+		std::array<char, 4096> data;
+		while (success && !isReplyComplete(reply, commandCount)) {
+			const ssize_t size = recv(fd, data.data(), data.size(), 0);
+			if (size <= 0) {
+				success = size < 0 && errno == EINTR;
+				continue;
+			}
+			reply.append(data.data(), static_cast<size_t>(size));
+		}
+		close(fd);
+		return success;
+	}
+
+	bool initControlSocket(ControlHandler handler) {
+		socketPath = getControlSocketPath();
+		if (socketPath.size() >= sizeof(sockaddr_un::sun_path)) {
+			VI_WARN("Control socket path is too long: %s", socketPath.c_str());
+			return false;
+		}
+		if (isOwnedByOtherInstance()) {
+			VI_WARN("Control socket %s is in use by another instance.", socketPath.c_str());
+			return false;
+		}
+		unlink(socketPath.c_str()); // Left behind by an instance that did not exit cleanly.
+
+		listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		const sockaddr_un address = getAddress();
+		bool bound = false;
+		if (listenFd >= 0) {
+			// Created private, as /tmp is shared with other users and a chmod afterwards would leave a window open.
+			const mode_t mask = umask(S_IRWXG | S_IRWXO);
+			bound = bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+			umask(mask); // Never fails or sets errno.
+		}
+		if (!bound || listen(listenFd, SOMAXCONN) != 0) {
+			VI_WARN("Unable to create control socket %s: %s", socketPath.c_str(), strerror(errno));
+			quitControlSocket();
+			return false;
+		}
+
+		epollFd = epoll_create1(EPOLL_CLOEXEC);
+		wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (epollFd < 0 || wakeFd < 0 || !addToEpoll(wakeFd) || !addToEpoll(listenFd)) {
+			VI_WARN("Unable to poll control socket: %s", strerror(errno));
+			quitControlSocket();
+			return false;
+		}
+
+		controlHandler = std::move(handler);
+		controlThread = std::thread(runControlThread);
+		return true;
+	}
+
+	void quitControlSocket() noexcept {
+		// Only a running endpoint owns the socket file. Anything else may belong to another instance.
+		const bool running = controlThread.joinable();
+		if (running) {
+			const uint64_t value = 1;
+			write(wakeFd, &value, sizeof(value));
+			controlThread.join();
+		}
+
+		for (const auto& [fd, client] : clients) {
+			close(fd);
+		}
+		clients.clear();
+		if (running) {
+			unlink(socketPath.c_str());
+		}
+		for (int fd : {listenFd, wakeFd, epollFd}) {
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+		listenFd = wakeFd = epollFd = -1;
+		controlHandler = nullptr;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,177 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifdef VI_PLATFORM_WINDOWS
+
+#include "ControlSocket.h"
+#include "../Log.h"
+#include "../Exceptions.h"
+
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <format>
+
+#include <Windows.h>
+
+namespace vi {
+	extern ControlHandler controlHandler;
+
+	namespace {
+		// Clients that send more than this without a newline are disconnected.
+		constexpr size_t maxLineLength = 64 * 1024;
+		constexpr DWORD bufferSize = 4096;
+
+		std::thread controlThread;
+		HANDLE pipe = INVALID_HANDLE_VALUE;
+		std::atomic_bool quitting = false;
+		std::atomic_bool finished = false;
+
+		HANDLE createPipe(DWORD flags) noexcept {
+			const std::string path = getControlSocketPath();
+			return CreateNamedPipeA(
+				path.c_str(),
+				PIPE_ACCESS_DUPLEX | flags,
+				PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+				1,
+				bufferSize,
+				bufferSize,
+				0,
+				nullptr
+			);
+		}
+
+		bool writeAll(std::string_view data) noexcept {
+			while (!data.empty()) {
+				DWORD written = 0;
+				if (!WriteFile(pipe, data.data(), static_cast<DWORD>(data.size()), &written, nullptr)) {
+					return false;
+				}
+				data.remove_prefix(written);
+			}
+			return true;
+		}
+
+		// Serves one client until it disconnects. Pipe instances are limited to one, so clients queue up.
+		void serveClient() noexcept {
+			std::string buffer;
+			std::array<char, bufferSize> data;
+			DWORD size = 0;
+			while (!quitting && ReadFile(pipe, data.data(), static_cast<DWORD>(data.size()), &size, nullptr) && size > 0) {
+				buffer.append(data.data(), size);
+
+				// Every command in this read is answered with a single write.
+				std::string reply;
+				try {
+					reply = processControlInput(buffer);
+				} catch (const std::exception& e) {
+					reply = std::format("err {}\n", e.what());
+					buffer.clear();
+				}
+				if ((!reply.empty() && !writeAll(reply)) || buffer.size() > maxLineLength) {
+					break;
+				}
+			}
+			FlushFileBuffers(pipe);
+			DisconnectNamedPipe(pipe);
+		}
+
+		void runControlThread() noexcept {
+			while (!quitting) {
+				if (ConnectNamedPipe(pipe, nullptr) || GetLastError() == ERROR_PIPE_CONNECTED) {
+					serveClient();
+				} else if (!quitting) {
+					VI_ERROR("ConnectNamedPipe failed: %lu", GetLastError());
+					break;
+				}
+			}
+			finished = true;
+		}
+	}
+
+	std::string getControlSocketPath() {
+		return std::format("\\\\.\\pipe\\{}", VI_EXECUTEABLE_NAME);
+	}
+
+	bool sendControlCommands(std::string_view commands, std::string& reply) noexcept {
+		const std::string path = getControlSocketPath();
+		HANDLE client = INVALID_HANDLE_VALUE;
+		// The pipe serves one client at a time, so wait for a turn if it is busy.
+		for (int attempt = 0; attempt < 2 && client == INVALID_HANDLE_VALUE; attempt++) {
+			client = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+			if (client == INVALID_HANDLE_VALUE && (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeA(path.c_str(), 2000))) {
+				return false;
+			}
+		}
+		if (client == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		const size_t commandCount = static_cast<size_t>(std::count(commands.begin(), commands.end(), '\n'));
+		bool success = true;
+		while (success && !commands.empty()) {
+			DWORD written = 0;
+			success = WriteFile(client, commands.data(), static_cast<DWORD>(commands.size()), &written, nullptr);
+			commands.remove_prefix(written);
+		}
+
+		std::array<char, bufferSize> data;
+		while (success && !isReplyComplete(reply, commandCount)) {
+			DWORD size = 0;
+			success = ReadFile(client, data.data(), static_cast<DWORD>(data.size()), &size, nullptr) && size > 0;
+			reply.append(data.data(), size);
+		}
+		CloseHandle(client);
+		return success;
+	}
+
+	bool initControlSocket(ControlHandler handler) {
+		// Fails if another instance already created the pipe.
+		pipe = createPipe(FILE_FLAG_FIRST_PIPE_INSTANCE);
+		if (pipe == INVALID_HANDLE_VALUE) {
+			VI_WARN("Unable to create control pipe: %lu", GetLastError());
+			return false;
+		}
+
+		controlHandler = std::move(handler);
+		quitting = false;
+		finished = false;
+		controlThread = std::thread(runControlThread);
+		return true;
+	}
+
+	void quitControlSocket() noexcept {
+		if (controlThread.joinable()) {
+			quitting = true;
+			// Unblocks ConnectNamedPipe or ReadFile. Repeated, as the thread may be between calls the first time.
+			while (!finished) {
+				CancelSynchronousIo(controlThread.native_handle());
+				Sleep(1);
+			}
+			controlThread.join();
+		}
+		if (pipe != INVALID_HANDLE_VALUE) {
+			CloseHandle(pipe);
+			pipe = INVALID_HANDLE_VALUE;
+		}
+		controlHandler = nullptr;
+	}
+}
+
+#endif
\ No newline at end of file
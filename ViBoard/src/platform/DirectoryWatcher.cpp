@@ -0,0 +1,74 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "DirectoryWatcher.h"
+#include "../Log.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	// Set before the watcher starts, and only called by its thread.
+	DirectoryChangeHandler directoryChangeHandler;
+
+	namespace {
+		struct PendingChanges {
+			std::vector<FileChange> changes;
+			Uint64 lastChange = 0;
+		};
+
+		// Only accessed by the watcher thread.
+		std::unordered_map<fs::path, PendingChanges> pending;
+	}
+
+	void queueDirectoryChange(const fs::path& directory, FileChange change) {
+		PendingChanges& entry = pending[directory];
+		entry.changes.push_back(std::move(change));
+		entry.lastChange = SDL_GetTicks();
+	}
+
+	int dispatchDirectoryChanges() noexcept {
+		const Uint64 now = SDL_GetTicks();
+		Uint64 wait = std::numeric_limits<Uint64>::max();
+		for (auto it = pending.begin(); it != pending.end();) {
+			const Uint64 quiet = now - it->second.lastChange;
+			if (quiet < directoryChangeSettleDelay) {
+				wait = std::min(wait, directoryChangeSettleDelay - quiet);
+				++it;
+				continue;
+			}
+
+			try {
+				directoryChangeHandler(it->first, std::move(it->second.changes));
+			} catch (const std::exception& e) {
+				VI_ERROR("Unable to handle changes to %s: %s", it->first.string().c_str(), e.what());
+				std::ignore = e;
+			}
+			it = pending.erase(it);
+		}
+		return wait == std::numeric_limits<Uint64>::max() ? -1 : static_cast<int>(wait);
+	}
+
+	void clearDirectoryChanges() noexcept {
+		pending.clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+namespace vi {
+	enum class FileAction {
+		// Created, written to or moved into the directory. New and existing files are not told apart.
+		Changed,
+		// Deleted, or moved out of the directory.
+		Removed,
+		// Changes were lost or the directory itself was moved or deleted, so it has to be scanned again.
+		// The path is the directory's.
+		Rescan
+	};
+
+	struct FileChange {
+		std::filesystem::path path;
+		FileAction action;
+	};
+
+	// Watches directories for changes to the files directly inside them, through inotify on Linux and
+	// ReadDirectoryChangesW on Windows. Nothing is polled.
+	//
+	// Changes to a directory are held back until none have arrived for settleDelay, as saving or copying a file
+	// usually reports several. The handler is then called on the watcher thread with the whole batch, in order.
+	using DirectoryChangeHandler = std::function<void(const std::filesystem::path& directory, std::vector<FileChange> changes)>;
+
+	// In milliseconds.
+	inline constexpr Uint64 directoryChangeSettleDelay = 200;
+
+	bool initDirectoryWatcher(DirectoryChangeHandler handler);
+	void quitDirectoryWatcher() noexcept;
+
+	// Thread-safe. Failures are logged, as a directory that is not watched can still be refreshed by hand.
+	void watchDirectory(const std::filesystem::path& directory) noexcept;
+	void unwatchDirectory(const std::filesystem::path& directory) noexcept;
+
+	// Only called by the watcher thread. Holds a change back until its directory has settled.
+	void queueDirectoryChange(const std::filesystem::path& directory, FileChange change);
+	// Hands every settled batch to the handler. Returns milliseconds until the next one is due, or -1 if none are queued.
+	int dispatchDirectoryChanges() noexcept;
+	// Drops changes that were never dispatched, once the watcher thread has stopped.
+	void clearDirectoryChanges() noexcept;
+}
\ No newline at end of file
@@ -0,0 +1,186 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifdef VI_PLATFORM_LINUX
+
+#include "DirectoryWatcher.h"
+#include "../Log.h"
+
+#include <array>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <errno.h>
+#include <string.h>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	extern DirectoryChangeHandler directoryChangeHandler;
+
+	namespace {
+		// Files are only reported once closed after writing, so half-written ones are never picked up.
+		constexpr uint32_t watchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+		std::thread watcherThread;
+		int inotifyFd = -1;
+		int wakeFd = -1;
+
+		// Guards both maps, as directories are watched and unwatched from other threads.
+		std::mutex watchMutex;
+		std::unordered_map<int, fs::path> directories;
+		std::unordered_map<fs::path, int> descriptors;
+
+		void queueEvent(const inotify_event& event) {
+			if (event.mask & IN_Q_OVERFLOW) {
+				for (const auto& [descriptor, directory] : directories) {
+					queueDirectoryChange(directory, {directory, FileAction::Rescan});
+				}
+				return;
+			}
+
+			const auto it = directories.find(event.wd);
+			if (it == directories.end()) {
+				// Unwatched since.
+				return;
+			}
+			const fs::path& directory = it->second;
+
+			if (event.mask & IN_IGNORED) {
+				// The watch is gone, whether removed by us or along with the directory.
+				descriptors.erase(directory);
+				directories.erase(it);
+			} else if (event.mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+				queueDirectoryChange(directory, {directory, FileAction::Rescan});
+			} else if (event.len > 0 && !(event.mask & IN_ISDIR)) {
+				const FileAction action = event.mask & (IN_DELETE | IN_MOVED_FROM) ? FileAction::Removed : FileAction::Changed;
+				queueDirectoryChange(directory, {directory / event.name, action});
+			}
+		}
+
+		void readEvents() {
+			alignas(inotify_event) std::array<char, 16 * 1024> buffer;
+			while (true) {
+				const ssize_t size = read(inotifyFd, buffer.data(), buffer.size());
+				if (size <= 0) {
+					if (size < 0 && errno == EINTR) {
+						continue;
+					}
+					return;
+				}
+
+				std::lock_guard lock(watchMutex);
+				for (ssize_t offset = 0; offset < size;) {
+					const auto& event = *reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+					queueEvent(event);
+					offset += static_cast<ssize_t>(sizeof(inotify_event) + event.len);
+				}
+			}
+		}
+
+		void runWatcherThread() noexcept {
+			std::array<pollfd, 2> fds{{{inotifyFd, POLLIN, 0}, {wakeFd, POLLIN, 0}}};
+			while (true) {
+				if (poll(fds.data(), fds.size(), dispatchDirectoryChanges()) < 0 && errno != EINTR) {
+					VI_ERROR("poll failed: %s", strerror(errno));
+					return;
+				}
+				if (fds[1].revents & POLLIN) {
+					return;
+				}
+				if (fds[0].revents & POLLIN) {
+					try {
+						readEvents();
+					} catch (const std::exception& e) {
+						VI_ERROR("Unable to read directory changes: %s", e.what());
+						std::ignore = e;
+					}
+				}
+			}
+		}
+	}
+
+	bool initDirectoryWatcher(DirectoryChangeHandler handler) {
+		inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (inotifyFd < 0 || wakeFd < 0) {
+			VI_WARN("Unable to create directory watcher: %s", strerror(errno));
+			quitDirectoryWatcher();
+			return false;
+		}
+
+		directoryChangeHandler = std::move(handler);
+		watcherThread = std::thread(runWatcherThread);
+		return true;
+	}
+
+	void quitDirectoryWatcher() noexcept {
+		if (watcherThread.joinable()) {
+			const uint64_t value = 1;
+			write(wakeFd, &value, sizeof(value));
+			watcherThread.join();
+		}
+
+		// Closing the inotify descriptor removes all of its watches.
+		for (int fd : {inotifyFd, wakeFd}) {
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+		inotifyFd = wakeFd = -1;
+		directories.clear();
+		descriptors.clear();
+		clearDirectoryChanges();
+		directoryChangeHandler = nullptr;
+	}
+
+	void watchDirectory(const fs::path& directory) noexcept {
+		std::lock_guard lock(watchMutex);
+		if (inotifyFd < 0 || descriptors.contains(directory)) {
+			return;
+		}
+
+		const int descriptor = inotify_add_watch(inotifyFd, directory.c_str(), watchMask);
+		if (descriptor < 0) {
+			VI_WARN("Unable to watch %s: %s", directory.c_str(), strerror(errno));
+			return;
+		}
+		// Two paths to the same directory share a descriptor. The last one watched gets its changes.
+		directories[descriptor] = directory;
+		descriptors[directory] = descriptor;
+	}
+
+	void unwatchDirectory(const fs::path& directory) noexcept {
+		std::lock_guard lock(watchMutex);
+		const auto it = descriptors.find(directory);
+		if (it == descriptors.end()) {
+			return;
+		}
+		inotify_rm_watch(inotifyFd, it->second);
+		directories.erase(it->second);
+		descriptors.erase(it);
+	}
+}
+
+#endif
\ No newline at end of file
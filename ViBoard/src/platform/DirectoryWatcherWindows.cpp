@@ -0,0 +1,273 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifdef VI_PLATFORM_WINDOWS
+
+#include "DirectoryWatcher.h"
+#include "../Log.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include <Windows.h>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	extern DirectoryChangeHandler directoryChangeHandler;
+
+	namespace {
+		// Writes are reported as they happen rather than on close, so the settle delay is what keeps
+		// half-copied files from being picked up.
+		constexpr DWORD notifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+		struct Watch {
+			fs::path directory;
+			HANDLE handle = INVALID_HANDLE_VALUE;
+			OVERLAPPED overlapped{};
+			alignas(DWORD) std::array<std::byte, 64 * 1024> buffer;
+		};
+
+		struct Request {
+			fs::path directory;
+			bool watch = false;
+		};
+
+		std::thread watcherThread;
+		HANDLE port = nullptr;
+
+		// Watching is requested from other threads, and done by the watcher thread.
+		std::mutex requestMutex;
+		std::vector<Request> requests;
+		bool quitting = false;
+
+		// Only accessed by the watcher thread. Reads complete on the port with their watch as the key.
+		std::unordered_map<fs::path, std::unique_ptr<Watch>> watches;
+		// Cancelled watches. Each is freed once its read completes, as the read writes into its buffer until then.
+		std::vector<std::unique_ptr<Watch>> closing;
+
+		bool beginRead(Watch& watch) noexcept {
+			return ReadDirectoryChangesW(watch.handle, watch.buffer.data(), static_cast<DWORD>(watch.buffer.size()),
+				FALSE, notifyFilter, nullptr, &watch.overlapped, nullptr);
+		}
+
+		void addWatch(const fs::path& directory) {
+			if (watches.contains(directory)) {
+				return;
+			}
+
+			auto watch = std::make_unique<Watch>();
+			watch->directory = directory;
+			watch->handle = CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+				nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+			if (watch->handle == INVALID_HANDLE_VALUE) {
+				VI_WARN("Unable to watch %s: %lu", directory.string().c_str(), GetLastError());
+				return;
+			}
+			if (!CreateIoCompletionPort(watch->handle, port, reinterpret_cast<ULONG_PTR>(watch.get()), 0) || !beginRead(*watch)) {
+				VI_WARN("Unable to watch %s: %lu", directory.string().c_str(), GetLastError());
+				CloseHandle(watch->handle);
+				return;
+			}
+			watches.emplace(directory, std::move(watch));
+		}
+
+		void removeWatch(const fs::path& directory) {
+			const auto it = watches.find(directory);
+			if (it == watches.end()) {
+				return;
+			}
+			CancelIoEx(it->second->handle, &it->second->overlapped);
+			closing.push_back(std::move(it->second));
+			watches.erase(it);
+		}
+
+		void queueChanges(const Watch& watch, DWORD size) {
+			if (size == 0) {
+				// The buffer overflowed, so changes were lost.
+				queueDirectoryChange(watch.directory, {watch.directory, FileAction::Rescan});
+				return;
+			}
+
+			for (DWORD offset = 0;;) {
+				const auto& info = *reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(watch.buffer.data() + offset);
+				const std::wstring_view name(info.FileName, info.FileNameLength / sizeof(WCHAR));
+				const bool removed = info.Action == FILE_ACTION_REMOVED || info.Action == FILE_ACTION_RENAMED_OLD_NAME;
+				queueDirectoryChange(watch.directory, {watch.directory / name, removed ? FileAction::Removed : FileAction::Changed});
+
+				if (info.NextEntryOffset == 0) {
+					break;
+				}
+				offset += info.NextEntryOffset;
+			}
+		}
+
+		void onReadComplete(Watch* watch, bool success, DWORD size) {
+			const auto closed = std::find_if(closing.begin(), closing.end(), [watch](const std::unique_ptr<Watch>& other) {
+				return other.get() == watch;
+			});
+			if (closed != closing.end()) {
+				CloseHandle((*closed)->handle);
+				closing.erase(closed);
+				return;
+			}
+
+			if (success) {
+				queueChanges(*watch, size);
+				if (beginRead(*watch)) {
+					return;
+				}
+			}
+
+			// Usually because the directory was deleted. Nothing is pending on it any more, so it can go straight away.
+			const fs::path directory = watch->directory;
+			VI_WARN("Stopped watching %s: %lu", directory.string().c_str(), GetLastError());
+			queueDirectoryChange(directory, {directory, FileAction::Rescan});
+			CloseHandle(watch->handle);
+			watches.erase(directory);
+		}
+
+		void runWatcherThread() noexcept {
+			while (true) {
+				const int timeout = dispatchDirectoryChanges();
+				DWORD size = 0;
+				ULONG_PTR key = 0;
+				OVERLAPPED* overlapped = nullptr;
+				const bool success = GetQueuedCompletionStatus(port, &size, &key, &overlapped, timeout < 0 ? INFINITE : static_cast<DWORD>(timeout));
+
+				try {
+					if (overlapped) {
+						onReadComplete(reinterpret_cast<Watch*>(key), success, size);
+						continue;
+					}
+					if (!success) {
+						if (GetLastError() != WAIT_TIMEOUT) {
+							VI_ERROR("GetQueuedCompletionStatus failed: %lu", GetLastError());
+							break;
+						}
+						continue;
+					}
+
+					std::vector<Request> taken;
+					{
+						std::lock_guard lock(requestMutex);
+						if (quitting) {
+							break;
+						}
+						taken = std::exchange(requests, {});
+					}
+					for (const Request& request : taken) {
+						if (request.watch) {
+							addWatch(request.directory);
+						} else {
+							removeWatch(request.directory);
+						}
+					}
+				} catch (const std::exception& e) {
+					VI_ERROR("Unable to process directory changes: %s", e.what());
+					std::ignore = e;
+				}
+			}
+
+			// Waits out every cancelled read before the buffers they write into are freed.
+			while (!watches.empty()) {
+				removeWatch(watches.begin()->first);
+			}
+			while (!closing.empty()) {
+				DWORD size = 0;
+				ULONG_PTR key = 0;
+				OVERLAPPED* overlapped = nullptr;
+				const bool success = GetQueuedCompletionStatus(port, &size, &key, &overlapped, INFINITE);
+				if (overlapped) {
+					onReadComplete(reinterpret_cast<Watch*>(key), success, size);
+				} else if (!success) {
+					break;
+				}
+			}
+		}
+
+		void postRequest(Request request) {
+			if (!port) {
+				return;
+			}
+			{
+				std::lock_guard lock(requestMutex);
+				requests.push_back(std::move(request));
+			}
+			PostQueuedCompletionStatus(port, 0, 0, nullptr);
+		}
+	}
+
+	bool initDirectoryWatcher(DirectoryChangeHandler handler) {
+		port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+		if (!port) {
+			VI_WARN("Unable to create directory watcher: %lu", GetLastError());
+			return false;
+		}
+
+		directoryChangeHandler = std::move(handler);
+		quitting = false;
+		watcherThread = std::thread(runWatcherThread);
+		return true;
+	}
+
+	void quitDirectoryWatcher() noexcept {
+		if (watcherThread.joinable()) {
+			{
+				std::lock_guard lock(requestMutex);
+				quitting = true;
+			}
+			PostQueuedCompletionStatus(port, 0, 0, nullptr);
+			watcherThread.join();
+		}
+		if (port) {
+			CloseHandle(port);
+			port = nullptr;
+		}
+		requests.clear();
+		clearDirectoryChanges();
+		directoryChangeHandler = nullptr;
+	}
+
+	void watchDirectory(const fs::path& directory) noexcept {
+		try {
+			postRequest({directory, true});
+		} catch (const std::exception& e) {
+			VI_WARN("Unable to watch %s: %s", directory.string().c_str(), e.what());
+			std::ignore = e;
+		}
+	}
+
+	void unwatchDirectory(const fs::path& directory) noexcept {
+		try {
+			postRequest({directory, false});
+		} catch (const std::exception& e) {
+			VI_WARN("Unable to unwatch %s: %s", directory.string().c_str(), e.what());
+			std::ignore = e;
+		}
+	}
+}
+
+#endif
\ No newline at end of file
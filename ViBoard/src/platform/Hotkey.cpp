@@ -18,17 +18,23 @@
 
 #include "Hotkey.h"
 
-#include <vector>
+#include <mutex>
 #include <assert.h>
 
 namespace vi {
-	std::vector<Hotkey> hotkeys;
+	// Only written to by the main thread, which may read it freely. The hotkey thread must hold hotkeyMutex.
+	SlotMap<Hotkey> hotkeys;
+	std::mutex hotkeyMutex;
+	// Only accessed by the hotkey thread.
+	Uint64 hotkeyPressTime = 0;
+
+	Uint64 getHotkeyPressTime() noexcept {
+		return hotkeyPressTime;
+	}
 
 	bool isValidHotkey(HotkeyId id) noexcept {
-		if (id < 0 || id >= static_cast<int>(hotkeys.size())) {
-			return false;
-		}
-		return hotkeys[id].scancode != SDL_SCANCODE_UNKNOWN;
+		const Hotkey* hotkey = hotkeys.get(id);
+		return hotkey && hotkey->scancode != SDL_SCANCODE_UNKNOWN;
 	}
 
 	Hotkey& getHotkey(HotkeyId id) noexcept {
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include "../SlotMap.h"
+
 #include <SDL3/SDL.h>
 
 #include <functional>
@@ -25,8 +27,6 @@
 #include <stdint.h>
 
 namespace vi {
-	class Application;
-
 	struct Hotkey {
 		SDL_Scancode scancode = SDL_SCANCODE_UNKNOWN;
 		uint16_t raw = 0;
@@ -34,17 +34,34 @@ namespace vi {
 		std::function<void()> callback;
 	};
 
-	using HotkeyId = int;
-	inline constexpr HotkeyId nullHotkey = -1;
+	// IDs of unregistered hotkeys stay invalid, even once their slot is reused by another hotkey.
+	using HotkeyId = Handle<Hotkey>;
+	inline constexpr HotkeyId nullHotkey{};
+
+	// Hotkeys are received and their callbacks run on a dedicated thread, independently of the UI.
+	// Callbacks must therefore be thread-safe.
+	void initHotkeys();
+	void quitHotkeys() noexcept;
 
+	// Must be called from the main thread.
 	HotkeyId registerHotkey(const Hotkey& hotKey) noexcept;
 	bool unregisterHotkey(HotkeyId id) noexcept;
+	// Blocks until any callback that is currently running has returned.
+	void flushHotkeys() noexcept;
+
+	// When the OS first saw the key press currently being dispatched, in SDL_GetTicksNS() time.
+	// Only meaningful from within a hotkey callback.
+	Uint64 getHotkeyPressTime() noexcept;
+
+#ifdef VI_PLATFORM_LINUX
+	// Returns a file descriptor that is read exactly like a keyboard. Writing input_event structs to it
+	// triggers hotkeys with no keyboard attached. Closing it removes the source. Returns -1 on failure.
+	int openFakeHotkeyInput() noexcept;
+#endif
 
 	bool isValidHotkey(HotkeyId id) noexcept;
 	Hotkey& getHotkey(HotkeyId id) noexcept;
 
-	void processHotkeyPresses(const Application& app) noexcept;
-
 	std::string modsToString(SDL_Keymod mod) noexcept;
 	std::string getHotkeyName(HotkeyId id) noexcept;
 
@@ -0,0 +1,448 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifdef VI_PLATFORM_LINUX
+
+#include "Hotkey.h"
+#include "Platform.h"
+#include "KeycodesLinux.h"
+#include "../Log.h"
+#include "../Exceptions.h"
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <filesystem>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/input.h>
+
+using namespace std::string_literals;
+namespace fs = std::filesystem;
+
+namespace vi {
+	extern SlotMap<Hotkey> hotkeys;
+	extern std::mutex hotkeyMutex;
+	extern Uint64 hotkeyPressTime;
+
+	namespace {
+		constexpr const char* inputDirectory = "/dev/input";
+		// Enough for a burst of presses from every keyboard at once. Larger bursts are handled over several reads.
+		constexpr size_t maxBatchSize = 64;
+
+		// Modifier combinations are indexed by these bits in the lookup table.
+		enum ModBit : uint8_t {
+			ctrlBit = 1 << 0,
+			altBit = 1 << 1,
+			shiftBit = 1 << 2,
+			modCombinations = 1 << 3
+		};
+
+		// For every key and modifier combination, the hotkey bound to it.
+		using BindingTable = std::array<std::array<HotkeyId, modCombinations>, KEY_CNT>;
+
+		struct Device {
+			int fd;
+			dev_t number; // Keeps a device from being opened twice, as it may be reported more than once.
+		};
+
+		// The start of an event that was cut off by a read. Devices only hand out whole events, but pipes may not.
+		struct PartialEvent {
+			int fd;
+			size_t size;
+			std::array<char, sizeof(input_event)> bytes;
+		};
+
+		struct PendingPress {
+			HotkeyId id;
+			Uint64 time;
+		};
+
+		std::thread hotkeyThread;
+		int epollFd = -1;
+		int wakeFd = -1;
+		int watchFd = -1;
+
+		// Guarded by hotkeyMutex.
+		BindingTable bindings;
+		std::vector<int> fakeInputs;
+
+		// Held while a callback runs, so flushHotkeys() can wait on it.
+		std::mutex dispatchMutex;
+
+		// Only accessed by the hotkey thread.
+		std::vector<Device> devices;
+		std::vector<PartialEvent> partialEvents;
+		std::array<bool, KEY_CNT> heldKeys{};
+
+		uint8_t toModBits(SDL_Keymod mod) noexcept {
+			assert(ensureInSupportedRange(mod));
+
+			uint8_t bits = 0;
+			if (mod & SDL_KMOD_CTRL) {
+				bits |= ctrlBit;
+			}
+			if (mod & SDL_KMOD_ALT) {
+				bits |= altBit;
+			}
+			if (mod & SDL_KMOD_SHIFT) {
+				bits |= shiftBit;
+			}
+			return bits;
+		}
+
+		uint8_t getHeldModBits() noexcept {
+			uint8_t bits = 0;
+			if (heldKeys[KEY_LEFTCTRL] || heldKeys[KEY_RIGHTCTRL]) {
+				bits |= ctrlBit;
+			}
+			if (heldKeys[KEY_LEFTALT] || heldKeys[KEY_RIGHTALT]) {
+				bits |= altBit;
+			}
+			if (heldKeys[KEY_LEFTSHIFT] || heldKeys[KEY_RIGHTSHIFT]) {
+				bits |= shiftBit;
+			}
+			return bits;
+		}
+
+		bool addToEpoll(int fd) noexcept {
+			epoll_event event{};
+			event.events = EPOLLIN;
+			event.data.fd = fd;
+			return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+		}
+
+		bool isKeyboard(int fd) noexcept {
+			std::array<unsigned long, (KEY_CNT + sizeof(unsigned long) * 8 - 1) / (sizeof(unsigned long) * 8)> keys{};
+			if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys.data()) < 0) {
+				return false;
+			}
+			constexpr size_t bitsPerLong = sizeof(unsigned long) * 8;
+			return keys[KEY_A / bitsPerLong] & (1ul << (KEY_A % bitsPerLong));
+		}
+
+		// Our own push-to-talk key would otherwise come back in as a press, firing any hotkey bound to it.
+		bool isVirtualKeyboard(int fd) noexcept {
+			input_id id{};
+			std::array<char, 256> name{};
+			return ioctl(fd, EVIOCGID, &id) == 0 && id.bustype == BUS_VIRTUAL
+				&& ioctl(fd, EVIOCGNAME(name.size() - 1), name.data()) >= 0
+				&& strcmp(name.data(), virtualKeyboardName) == 0;
+		}
+
+		void openDevice(const fs::path& path) noexcept {
+			if (path.filename().string().rfind("event", 0) != 0) {
+				return;
+			}
+
+			const int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+			if (fd < 0) {
+				return; // Usually a lack of permissions, or not ready yet.
+			}
+			struct stat info;
+			if (fstat(fd, &info) != 0 || std::ranges::any_of(devices, [&](const Device& device) { return device.number == info.st_rdev; })) {
+				close(fd);
+				return;
+			}
+			if (!isKeyboard(fd) || isVirtualKeyboard(fd) || !addToEpoll(fd)) {
+				close(fd);
+				return;
+			}
+
+			// Timestamp events on the same clock SDL uses, rather than wall-clock time.
+			const int clock = CLOCK_MONOTONIC;
+			ioctl(fd, EVIOCSCLOCKID, &clock);
+			devices.push_back({fd, info.st_rdev});
+			VI_DEBUG("Listening for hotkeys on %s.", path.c_str());
+		}
+
+		void closeDevice(int fd) noexcept {
+			epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+			close(fd);
+			std::erase_if(devices, [fd](const Device& device) { return device.fd == fd; });
+			std::erase_if(partialEvents, [fd](const PartialEvent& partial) { return partial.fd == fd; });
+
+			std::lock_guard lock(hotkeyMutex);
+			std::erase(fakeInputs, fd);
+		}
+
+		// The kernel dropped events, so our idea of which keys are held may be wrong.
+		void resyncHeldKeys(int fd) noexcept {
+			constexpr size_t bitsPerByte = 8;
+			std::array<uint8_t, (KEY_CNT + bitsPerByte - 1) / bitsPerByte> state{};
+			if (ioctl(fd, EVIOCGKEY(sizeof(state)), state.data()) < 0) {
+				return;
+			}
+			for (uint16_t key : {KEY_LEFTCTRL, KEY_RIGHTCTRL, KEY_LEFTALT, KEY_RIGHTALT, KEY_LEFTSHIFT, KEY_RIGHTSHIFT}) {
+				heldKeys[key] = state[key / bitsPerByte] & (1 << (key % bitsPerByte));
+			}
+		}
+
+		Uint64 toTicks(const timeval& time) noexcept {
+			timespec now;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			const int64_t nowNs = static_cast<int64_t>(now.tv_sec) * SDL_NS_PER_SECOND + now.tv_nsec;
+			const int64_t eventNs = static_cast<int64_t>(time.tv_sec) * SDL_NS_PER_SECOND + static_cast<int64_t>(time.tv_usec) * SDL_NS_PER_US;
+
+			const Uint64 ticks = SDL_GetTicksNS();
+			const Uint64 age = static_cast<Uint64>(std::max<int64_t>(nowNs - eventNs, 0));
+			return ticks - std::min(age, ticks);
+		}
+
+		void processHotkeyPress(HotkeyId id, Uint64 time) noexcept {
+			std::lock_guard dispatchLock(dispatchMutex);
+			std::function<void()> callback;
+			{
+				// Copied out so the main thread is never blocked on a running callback.
+				std::lock_guard lock(hotkeyMutex);
+				if (!isValidHotkey(id)) {
+					return; // Unregistered while the press was queued, even if its slot was reused since.
+				}
+				callback = hotkeys[id].callback;
+			}
+			if (callback) {
+				hotkeyPressTime = time;
+				callback();
+				hotkeyPressTime = 0;
+			}
+		}
+
+		// Moves the bytes left over from the last read of fd to the start of out, returning how many there were.
+		size_t takePartialEvent(int fd, char* out) noexcept {
+			const auto partial = std::ranges::find(partialEvents, fd, &PartialEvent::fd);
+			if (partial == partialEvents.end()) {
+				return 0;
+			}
+			const size_t size = partial->size;
+			memcpy(out, partial->bytes.data(), size);
+			partialEvents.erase(partial);
+			return size;
+		}
+
+		void keepPartialEvent(int fd, const char* data, size_t size) noexcept {
+			if (size > 0) {
+				PartialEvent partial{fd, size, {}};
+				memcpy(partial.bytes.data(), data, size);
+				partialEvents.push_back(partial);
+			}
+		}
+
+		// Returns false once the source is gone.
+		bool readInput(int fd) noexcept {
+			std::array<input_event, maxBatchSize> events;
+			char* const bytes = reinterpret_cast<char*>(events.data());
+			const size_t carried = takePartialEvent(fd, bytes);
+			const ssize_t size = read(fd, bytes + carried, sizeof(events) - carried);
+			if (size <= 0) {
+				keepPartialEvent(fd, bytes, carried);
+				return size < 0 && (errno == EAGAIN || errno == EINTR);
+			}
+
+			const size_t total = carried + static_cast<size_t>(size);
+			const size_t eventCount = total / sizeof(input_event);
+			keepPartialEvent(fd, bytes + eventCount * sizeof(input_event), total % sizeof(input_event));
+
+			// Matched as a batch under one lock, then dispatched in order.
+			std::array<PendingPress, maxBatchSize> presses;
+			size_t count = 0;
+			{
+				std::lock_guard lock(hotkeyMutex);
+				for (size_t i = 0; i < eventCount; i++) {
+					const input_event& event = events[i];
+					if (event.type == EV_SYN && event.code == SYN_DROPPED) {
+						resyncHeldKeys(fd);
+						continue;
+					}
+					if (event.type != EV_KEY || event.code >= KEY_CNT) {
+						continue;
+					}
+
+					// 0 is a release, 1 a press and 2 an auto-repeat, which is ignored like MOD_NOREPEAT on Windows.
+					if (event.value == 1) {
+						const HotkeyId id = bindings[event.code][getHeldModBits()];
+						if (id != nullHotkey) {
+							presses[count++] = {id, toTicks(event.time)};
+						}
+					}
+					if (event.value != 2) {
+						heldKeys[event.code] = event.value == 1;
+					}
+				}
+			}
+
+			for (size_t i = 0; i < count; i++) {
+				processHotkeyPress(presses[i].id, presses[i].time);
+			}
+			return true;
+		}
+
+		void processWatchEvents() noexcept {
+			alignas(inotify_event) std::array<char, 4096> buffer;
+			const ssize_t size = read(watchFd, buffer.data(), buffer.size());
+			for (ssize_t offset = 0; offset < size;) {
+				const inotify_event& event = *reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+				if (event.len > 0) {
+					openDevice(fs::path(inputDirectory) / event.name);
+				}
+				offset += sizeof(inotify_event) + event.len;
+			}
+		}
+
+		void runHotkeyThread() noexcept {
+			SDL_SetCurrentThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+			std::error_code error;
+			for (const auto& entry : fs::directory_iterator(inputDirectory, error)) {
+				openDevice(entry.path());
+			}
+			if (devices.empty()) {
+				VI_WARN("Unable to open any keyboards in %s. Global hotkeys require read access, usually through the \"input\" group.", inputDirectory);
+			}
+
+			std::array<epoll_event, 16> ready;
+			while (true) {
+				const int count = epoll_wait(epollFd, ready.data(), static_cast<int>(ready.size()), -1);
+				if (count < 0 && errno != EINTR) {
+					VI_ERROR("epoll_wait failed: %s", strerror(errno));
+					break;
+				}
+
+				for (int i = 0; i < count; i++) {
+					const int fd = ready[i].data.fd;
+					if (fd == wakeFd) {
+						return;
+					}
+					if (fd == watchFd) {
+						processWatchEvents();
+					} else if (!readInput(fd) || (ready[i].events & (EPOLLERR | EPOLLHUP))) {
+						closeDevice(fd);
+					}
+				}
+			}
+		}
+	}
+
+	HotkeyId registerHotkey(const Hotkey& hotkey) noexcept {
+		assert(hotkey.raw != 0); // Hotkey must have a valid scancode.
+
+		const uint16_t key = toEvdevKey(hotkey.scancode);
+		if (key == 0 || key >= KEY_CNT) {
+			VI_ERROR("Failed to register hotkey: %s has no evdev equivalent.", SDL_GetScancodeName(hotkey.scancode));
+			return nullHotkey;
+		}
+
+		std::lock_guard lock(hotkeyMutex);
+		HotkeyId& binding = bindings[key][toModBits(hotkey.mod & ~SDL_KMOD_NUM)];
+		if (binding != nullHotkey) {
+			VI_ERROR("Failed to register hotkey: %s is already in use.", SDL_GetScancodeName(hotkey.scancode));
+			return nullHotkey;
+		}
+
+		binding = hotkeys.insert(hotkey);
+		return binding;
+	}
+
+	bool unregisterHotkey(HotkeyId id) noexcept {
+		std::lock_guard lock(hotkeyMutex);
+		if (!isValidHotkey(id)) {
+			VI_ERROR("Invalid hotkey ID! %u", id.index);
+			return false;
+		}
+
+		const Hotkey& hotkey = hotkeys[id];
+		bindings[toEvdevKey(hotkey.scancode)][toModBits(hotkey.mod & ~SDL_KMOD_NUM)] = nullHotkey;
+		hotkeys.erase(id);
+		return true;
+	}
+
+	void flushHotkeys() noexcept {
+		std::lock_guard lock(dispatchMutex);
+	}
+
+	int openFakeHotkeyInput() noexcept {
+		int fds[2];
+		if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+			return -1;
+		}
+		if (!addToEpoll(fds[0])) {
+			close(fds[0]);
+			close(fds[1]);
+			return -1;
+		}
+
+		std::lock_guard lock(hotkeyMutex);
+		fakeInputs.push_back(fds[0]);
+		return fds[1];
+	}
+
+	void initHotkeys() {
+		epollFd = epoll_create1(EPOLL_CLOEXEC);
+		wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (epollFd < 0 || wakeFd < 0 || !addToEpoll(wakeFd)) {
+			throw ExternalError("Unable to set up hotkey polling: "s + strerror(errno));
+		}
+
+		// Picks up keyboards that are plugged in later. IN_ATTRIB catches udev granting access after creation.
+		watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (watchFd < 0 || inotify_add_watch(watchFd, inputDirectory, IN_CREATE | IN_ATTRIB) < 0 || !addToEpoll(watchFd)) {
+			VI_WARN("Unable to watch %s for new keyboards.", inputDirectory);
+		}
+
+		hotkeyThread = std::thread(runHotkeyThread);
+	}
+
+	void quitHotkeys() noexcept {
+		if (!hotkeyThread.joinable()) {
+			return;
+		}
+
+		const uint64_t value = 1;
+		write(wakeFd, &value, sizeof(value));
+		hotkeyThread.join();
+
+		for (const Device& device : devices) {
+			close(device.fd);
+		}
+		devices.clear();
+		for (int fd : fakeInputs) {
+			close(fd);
+		}
+		fakeInputs.clear();
+		for (int fd : {watchFd, wakeFd, epollFd}) {
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+		watchFd = wakeFd = epollFd = -1;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -21,17 +21,50 @@
 #include "Hotkey.h"
 #include "../Log.h"
 #include "../Exceptions.h"
-#include "../Application.h"
 
+#include <array>
 #include <vector>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <future>
 #include <assert.h>
 
 #include <Windows.h>
 
 namespace vi {
-	extern std::vector<Hotkey> hotkeys;
+	extern SlotMap<Hotkey> hotkeys;
+	extern std::mutex hotkeyMutex;
+	extern Uint64 hotkeyPressTime;
 
 	namespace {
+		// RegisterHotKey binds hotkeys to the calling thread, so (un)registration is forwarded to the hotkey thread.
+		constexpr UINT registerMessage = WM_APP;
+		constexpr UINT unregisterMessage = WM_APP + 1;
+		constexpr UINT flushMessage = WM_APP + 2;
+
+		struct RegisterRequest {
+			HotkeyId id;
+			unsigned int mods = 0;
+			unsigned int vk = 0;
+			std::promise<bool> result;
+		};
+
+		// Enough for every hotkey on a keyboard going off at once. Larger bursts are handled over several batches.
+		constexpr size_t maxBatchSize = 64;
+
+		struct PendingMessage {
+			MSG msg;
+			Uint64 time; // When the OS received the message, in SDL_GetTicksNS() time.
+		};
+
+		std::thread hotkeyThread;
+		DWORD hotkeyThreadId = 0;
+
+		// RegisterHotKey IDs are limited to 16 bits, so slot indices are used and the generation each slot
+		// was registered under is kept here. Only accessed by the hotkey thread.
+		std::vector<uint32_t> registeredGenerations;
+
 		unsigned int SdlModToWin32(SDL_Keymod sdlMod) noexcept {
 			assert(ensureInSupportedRange(sdlMod));
 
@@ -67,17 +100,118 @@ namespace vi {
 			}
 			return MapVirtualKey(hotkey.raw, MAPVK_VSC_TO_VK);
 		}
+
+		void processHotkeyPress(uint32_t index, Uint64 time) noexcept {
+			if (index >= registeredGenerations.size()) {
+				return;
+			}
+			const HotkeyId id{index, registeredGenerations[index]};
+
+			std::function<void()> callback;
+			{
+				// Copied out so the main thread is never blocked on a running callback.
+				std::lock_guard lock(hotkeyMutex);
+				if (!isValidHotkey(id)) {
+					return; // Unregistered while the press was queued, even if its slot was reused since.
+				}
+				callback = hotkeys[id].callback;
+			}
+			if (callback) {
+				hotkeyPressTime = time;
+				callback();
+				hotkeyPressTime = 0;
+			}
+		}
+
+		void processMessage(const PendingMessage& pending) noexcept {
+			const MSG& msg = pending.msg;
+			switch (msg.message) {
+			case WM_HOTKEY:
+				processHotkeyPress(static_cast<uint32_t>(msg.wParam), pending.time);
+				break;
+
+			case registerMessage: {
+				RegisterRequest& request = *reinterpret_cast<RegisterRequest*>(msg.lParam);
+				if (request.id.index >= registeredGenerations.size()) {
+					registeredGenerations.resize(request.id.index + 1);
+				}
+				registeredGenerations[request.id.index] = request.id.generation;
+				request.result.set_value(RegisterHotKey(nullptr, static_cast<int>(request.id.index), request.mods, request.vk));
+				break;
+			}
+
+			case unregisterMessage:
+				if (!UnregisterHotKey(nullptr, static_cast<int>(msg.wParam))) {
+					VI_ERROR("Failed to unregister hotkey.");
+				}
+				break;
+
+			case flushMessage:
+				reinterpret_cast<std::promise<void>*>(msg.lParam)->set_value();
+				break;
+			}
+		}
+
+		void runHotkeyThread(std::promise<void>& ready) noexcept {
+			SDL_SetCurrentThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+			MSG msg;
+			PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE); // Creates this thread's message queue.
+			ready.set_value();
+
+			std::array<PendingMessage, maxBatchSize> batch;
+			bool running = true;
+			while (running && GetMessage(&msg, nullptr, 0, 0) > 0) {
+				// Drain everything that is already queued, so simultaneous presses are all handled in one wake-up.
+				size_t count = 0;
+				do {
+					if (msg.message == WM_QUIT) {
+						running = false;
+						break;
+					}
+					batch[count++].msg = msg;
+				} while (count < batch.size() && PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE));
+
+				// Message times come from GetTickCount(), so they are rebased onto SDL's clock.
+				const Uint64 now = SDL_GetTicksNS();
+				const DWORD tickNow = GetTickCount();
+				for (size_t i = 0; i < count; i++) {
+					const DWORD age = tickNow - batch[i].msg.time;
+					batch[i].time = now - std::min<Uint64>(static_cast<Uint64>(age) * SDL_NS_PER_MS, now);
+				}
+
+				for (size_t i = 0; i < count; i++) {
+					processMessage(batch[i]);
+				}
+			}
+		}
 	}
 
 	HotkeyId registerHotkey(const Hotkey& hotkey) noexcept {
 		assert(hotkey.raw != 0); // Hotkey must have a valid scancode.
 
-		const HotkeyId id = static_cast<HotkeyId>(hotkeys.size());
-		if (!RegisterHotKey(nullptr, id, SdlModToWin32(hotkey.mod) | MOD_NOREPEAT, getVk(hotkey))) {
+		HotkeyId id = nullHotkey;
+		{
+			// Reserve the slot. It stays invalid until registration succeeds.
+			std::lock_guard lock(hotkeyMutex);
+			id = hotkeys.insert(Hotkey());
+		}
+
+		RegisterRequest request;
+		request.id = id;
+		request.mods = SdlModToWin32(hotkey.mod) | MOD_NOREPEAT;
+		request.vk = getVk(hotkey);
+		std::future<bool> result = request.result.get_future();
+
+		if (!PostThreadMessage(hotkeyThreadId, registerMessage, 0, reinterpret_cast<LPARAM>(&request)) || !result.get()) {
 			VI_ERROR("Failed to register hotkey.");
+			std::lock_guard lock(hotkeyMutex);
+			hotkeys.erase(id);
 			return nullHotkey;
 		}
-		hotkeys.push_back(hotkey);
+
+		std::lock_guard lock(hotkeyMutex);
+		hotkeys[id] = hotkey;
 		return id;
 	}
 
@@ -86,22 +220,42 @@ namespace vi {
 			VI_ERROR("Invalid hotkey ID!");
 			return false;
 		}
-		if (!UnregisterHotKey(nullptr, id)) {
+		{
+			std::lock_guard lock(hotkeyMutex);
+			hotkeys.erase(id);
+		}
+
+		// Not waited on, so this is safe to call while holding locks that a running callback may need.
+		// The slot may be reused straight away, as the thread handles this before any later registration.
+		if (!PostThreadMessage(hotkeyThreadId, unregisterMessage, id.index, 0)) {
 			VI_ERROR("Failed to unregister hotkey.");
 			return false;
 		}
-		// We could also remember that this id was freed, then reuse it for next time.
-		// However, in practice, it's nearly impossible to run out of IDs or memory by registering too many hotkeys.
-		hotkeys[id] = Hotkey();
 		return true;
 	}
 
-	void processHotkeyPresses(const Application& app) noexcept {
-		MSG msg(0);
-		if (PeekMessage(&msg, nullptr, 0, 0, PM_NOREMOVE) && msg.message == WM_HOTKEY) { // System events get cleared by SDL in main event loop.
-			assert(isValidHotkey(static_cast<HotkeyId>(msg.wParam)));
-			hotkeys[msg.wParam].callback();
+	void flushHotkeys() noexcept {
+		std::promise<void> flushed;
+		std::future<void> result = flushed.get_future();
+		if (PostThreadMessage(hotkeyThreadId, flushMessage, 0, reinterpret_cast<LPARAM>(&flushed))) {
+			result.wait();
+		}
+	}
+
+	void initHotkeys() {
+		std::promise<void> ready;
+		std::future<void> started = ready.get_future();
+		hotkeyThread = std::thread(runHotkeyThread, std::ref(ready));
+		started.wait();
+		hotkeyThreadId = GetThreadId(hotkeyThread.native_handle());
+	}
+
+	void quitHotkeys() noexcept {
+		if (!hotkeyThread.joinable()) {
+			return;
 		}
+		PostThreadMessage(hotkeyThreadId, WM_QUIT, 0, 0);
+		hotkeyThread.join();
 	}
 }
 
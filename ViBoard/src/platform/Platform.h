@@ -20,7 +20,10 @@
 
 #include <SDL3/SDL.h>
 
+#include <filesystem>
+#include <string_view>
 #include <stdint.h>
+#include <stddef.h>
 
 namespace vi {
 	class Application;
@@ -29,9 +32,32 @@ namespace vi {
 	void quitPlatform() noexcept;
 
 	void onPlatformEvent(const Application& app) noexcept;
+	// Wakes the main thread if it is blocked in onPlatformEvent. Safe to call from any thread.
+	void wakeUpEventLoop() noexcept;
 
 	bool isLaunchingOnStartup();
 	bool setLaunchOnStartup(bool launch, SDL_Window* window);
 
-	void sendKeyPress(uint16_t scancode, bool pressed) noexcept;
+	// raw is the key's native scancode as reported by SDL. Platforms that cannot use it map the SDL scancode instead.
+	void sendKeyPress(SDL_Scancode scancode, uint16_t raw, bool pressed) noexcept;
+#ifdef VI_PLATFORM_LINUX
+	// The uinput device keys are sent through. The hotkey backend must not read it back as a keyboard.
+	inline constexpr const char* virtualKeyboardName = VI_EXECUTEABLE_NAME " virtual keyboard";
+#endif
+
+	size_t getPageSize() noexcept;
+
+	// Rounds size up to a whole number of pages.
+	inline size_t alignToPage(size_t size) noexcept {
+		const size_t page = getPageSize();
+		return (size + page - 1) / page * page;
+	}
+
+	// Pins memory touched by the audio thread so it can never be paged out. Best-effort, returns false if the OS refused.
+	bool lockMemory(const void* data, size_t size) noexcept;
+	void unlockMemory(const void* data, size_t size) noexcept;
+
+	// Replaces the file's contents through a temporary file, so it holds either the old or the new data
+	// even if the program or system dies partway through. Throws IOError on failure.
+	void replaceFile(const std::filesystem::path& path, std::string_view data);
 }
\ No newline at end of file
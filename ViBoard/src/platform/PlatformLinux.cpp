@@ -0,0 +1,260 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifdef VI_PLATFORM_LINUX
+#include "../Application.h"
+#include "Platform.h"
+#include "KeycodesLinux.h"
+#include "../Exceptions.h"
+#include "../Log.h"
+#include "Hotkey.h"
+
+#include <string>
+#include <filesystem>
+#include <fstream>
+#include <format>
+#include <array>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/uinput.h>
+
+using namespace std::string_literals;
+namespace fs = std::filesystem;
+
+namespace vi {
+	namespace {
+		// Virtual keyboard used to send the push-to-talk key. -1 if unavailable.
+		int uinputFd = -1;
+
+		Uint32 getWakeUpEventType() noexcept {
+			static const Uint32 type = SDL_RegisterEvents(1);
+			return type;
+		}
+
+		fs::path getAutostartPath() {
+			const char* configHome = getenv("XDG_CONFIG_HOME");
+			if (configHome && *configHome) {
+				return fs::path(configHome) / "autostart";
+			}
+			const char* home = getenv("HOME");
+			if (!home) {
+				throw ExternalError("HOME is not set.");
+			}
+			return fs::path(home) / ".config" / "autostart";
+		}
+
+		inline fs::path getAutostartEntry() {
+			return getAutostartPath() / (VI_EXECUTEABLE_NAME + ".desktop"s);
+		}
+
+		void createVirtualKeyboard() noexcept {
+			uinputFd = open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+			if (uinputFd < 0) {
+				VI_WARN("Unable to open /dev/uinput: %s. Push-to-talk will not be sent.", strerror(errno));
+				return;
+			}
+
+			ioctl(uinputFd, UI_SET_EVBIT, EV_KEY);
+			ioctl(uinputFd, UI_SET_EVBIT, EV_SYN);
+			for (int key = KEY_ESC; key <= KEY_MICMUTE; key++) {
+				ioctl(uinputFd, UI_SET_KEYBIT, key);
+			}
+
+			uinput_setup setup{};
+			setup.id.bustype = BUS_VIRTUAL;
+			strncpy(setup.name, virtualKeyboardName, UINPUT_MAX_NAME_SIZE - 1);
+			if (ioctl(uinputFd, UI_DEV_SETUP, &setup) < 0 || ioctl(uinputFd, UI_DEV_CREATE) < 0) {
+				VI_WARN("Unable to create virtual keyboard: %s. Push-to-talk will not be sent.", strerror(errno));
+				close(uinputFd);
+				uinputFd = -1;
+			}
+		}
+
+		void destroyVirtualKeyboard() noexcept {
+			if (uinputFd < 0) {
+				return;
+			}
+			ioctl(uinputFd, UI_DEV_DESTROY);
+			close(uinputFd);
+			uinputFd = -1;
+		}
+	}
+
+	void initPlatform() {
+		getWakeUpEventType();
+		createVirtualKeyboard();
+		initHotkeys();
+	}
+
+	void quitPlatform() noexcept {
+		quitHotkeys();
+		destroyVirtualKeyboard();
+	}
+
+	void onPlatformEvent(const Application& app) noexcept {
+		if (app.isInactive()) {
+			// Sleeps on the display connection and SDL's wake-up pipe, so an idle program uses no CPU.
+			SDL_WaitEvent(nullptr);
+		}
+	}
+
+	void wakeUpEventLoop() noexcept {
+		// Any pushed event makes SDL_WaitEvent return.
+		SDL_Event event{};
+		event.type = getWakeUpEventType();
+		SDL_PushEvent(&event);
+	}
+
+	bool isLaunchingOnStartup() {
+		return fs::exists(getAutostartEntry());
+	}
+
+	bool setLaunchOnStartup(bool launch, SDL_Window* window) {
+		if (!launch) {
+			const auto entry = getAutostartEntry();
+			if (fs::exists(entry)) {
+				fs::remove(entry);
+			}
+			return false;
+		} else {
+			std::error_code error;
+			const fs::path exePath = fs::read_symlink("/proc/self/exe", error);
+			if (!error) {
+				fs::create_directories(getAutostartPath(), error);
+			}
+
+			std::ofstream file;
+			if (!error) {
+				file.open(getAutostartEntry());
+				file << std::format(
+					"[Desktop Entry]\n"
+					"Type=Application\n"
+					"Name={}\n"
+					"Comment=Launch ViBoard\n"
+					"Exec=\"{}\"\n"
+					"Path={}\n"
+					"Terminal=false\n",
+					VI_EXECUTEABLE_NAME,
+					exePath.string(),
+					fs::current_path().string()
+				);
+			}
+
+			if (error || !file) {
+				SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
+					"Unable to open on startup",
+					"An error occured while trying to add program to startup programs.\n"
+					"Please ensure your autostart folder is writable.",
+					window);
+				return false;
+			}
+			return true;
+		}
+	}
+
+	void sendKeyPress(SDL_Scancode scancode, uint16_t, bool pressed) noexcept {
+		const uint16_t key = toEvdevKey(scancode);
+		if (uinputFd < 0 || key == 0) {
+			return;
+		}
+
+		// Written in one call, so the key reaches readers as a single report.
+		std::array<input_event, 2> events{};
+		events[0].type = EV_KEY;
+		events[0].code = key;
+		events[0].value = pressed ? 1 : 0;
+		events[1].type = EV_SYN;
+		events[1].code = SYN_REPORT;
+		if (write(uinputFd, events.data(), sizeof(events)) != sizeof(events)) {
+			VI_ERROR("Failed to send key press: %s", strerror(errno));
+		}
+	}
+
+	size_t getPageSize() noexcept {
+		static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		return size;
+	}
+
+	bool lockMemory(const void* data, size_t size) noexcept {
+		if (mlock(data, size) == 0) {
+			return true;
+		}
+		VI_WARN("Unable to lock %zu bytes of memory: %s", size, strerror(errno));
+		return false;
+	}
+
+	void unlockMemory(const void* data, size_t size) noexcept {
+		munlock(data, size);
+	}
+
+	void replaceFile(const fs::path& path, std::string_view data) {
+		fs::path temp = path;
+		temp += ".tmp";
+
+		const int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (fd == -1) {
+			throw IOError(std::format("Unable to create {}: {}", temp.string(), strerror(errno)));
+		}
+		for (size_t written = 0; written < data.size();) {
+			const ssize_t result = write(fd, data.data() + written, data.size() - written);
+			if (result == -1 && errno == EINTR) {
+				continue;
+			}
+			if (result == -1) {
+				const int error = errno;
+				close(fd);
+				unlink(temp.c_str());
+				throw IOError(std::format("Unable to write {}: {}", temp.string(), strerror(error)));
+			}
+			written += static_cast<size_t>(result);
+		}
+		// Without this, the rename may reach the disk before the data does.
+		if (fsync(fd) == -1) {
+			const int error = errno;
+			close(fd);
+			unlink(temp.c_str());
+			throw IOError(std::format("Unable to sync {}: {}", temp.string(), strerror(error)));
+		}
+		close(fd);
+
+		if (rename(temp.c_str(), path.c_str()) == -1) {
+			const int error = errno;
+			unlink(temp.c_str());
+			throw IOError(std::format("Unable to replace {}: {}", path.string(), strerror(error)));
+		}
+
+		// The rename is only durable once the directory holding it is synced as well.
+		const fs::path directory = path.has_parent_path() ? path.parent_path() : fs::path(".");
+		const int directoryFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (directoryFd == -1 || fsync(directoryFd) == -1) {
+			const int error = errno;
+			if (directoryFd != -1) {
+				close(directoryFd);
+			}
+			throw IOError(std::format("Unable to sync {}: {}", directory.string(), strerror(error)));
+		}
+		close(directoryFd);
+	}
+}
+#endif
\ No newline at end of file
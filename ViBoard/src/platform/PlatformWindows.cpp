@@ -20,11 +20,13 @@
 #include "../Application.h"
 #include "Platform.h"
 #include "../Exceptions.h"
+#include "../Log.h"
 #include "Hotkey.h"
 
 #include <string>
 #include <filesystem>
 #include <format>
+#include <algorithm>
 
 #include <Windows.h>
 #include <Shlobj_core.h>
@@ -39,6 +41,8 @@ namespace fs = std::filesystem;
 
 namespace vi {
 	namespace {
+		DWORD mainThreadId = 0;
+
 		fs::path getStartupFolderPath() {
 			PWSTR pszPath;
 			const HRESULT hr = SHGetKnownFolderPath(FOLDERID_Startup, 0, NULL, &pszPath);
@@ -87,13 +91,16 @@ namespace vi {
 	}
 
 	void initPlatform() {
+		mainThreadId = GetCurrentThreadId();
 		const HRESULT result = CoInitialize(nullptr);
 		if (result != S_OK && result != S_FALSE) {
 			throw ExternalError("CoInitialize failed.");
 		}
+		initHotkeys();
 	}
 
 	void quitPlatform() noexcept {
+		quitHotkeys();
 		CoUninitialize();
 	}
 
@@ -101,7 +108,11 @@ namespace vi {
 		if (app.isInactive()) {
 			WaitMessage();
 		}
-		processHotkeyPresses(app);
+	}
+
+	void wakeUpEventLoop() noexcept {
+		// Any message posted to the thread's queue makes WaitMessage return.
+		PostThreadMessage(mainThreadId, WM_NULL, 0, 0);
 	}
 
 	bool isLaunchingOnStartup() {
@@ -129,15 +140,81 @@ namespace vi {
 		}
 	}
 
-	void sendKeyPress(uint16_t scancode, bool pressed) noexcept {
+	void sendKeyPress(SDL_Scancode, uint16_t raw, bool pressed) noexcept {
 		INPUT input = {};
 		input.type = INPUT_KEYBOARD;
-		input.ki.wVk = MapVirtualKey(scancode, MAPVK_VSC_TO_VK);
-		input.ki.wScan = scancode;
+		input.ki.wVk = MapVirtualKey(raw, MAPVK_VSC_TO_VK);
+		input.ki.wScan = raw;
 		if (!pressed) {
 			input.ki.dwFlags = KEYEVENTF_KEYUP;
 		}
 		SendInput(1, &input, sizeof(INPUT));
 	}
+
+	size_t getPageSize() noexcept {
+		static const size_t size = []() {
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			return static_cast<size_t>(info.dwPageSize);
+		}();
+		return size;
+	}
+
+	bool lockMemory(const void* data, size_t size) noexcept {
+		if (VirtualLock(const_cast<void*>(data), size)) {
+			return true;
+		}
+
+		// The amount of lockable memory is bound by the minimum working set size, so grow it and try again.
+		HANDLE process = GetCurrentProcess();
+		SIZE_T minSize = 0;
+		SIZE_T maxSize = 0;
+		if (GetProcessWorkingSetSize(process, &minSize, &maxSize)
+			&& SetProcessWorkingSetSize(process, minSize + size, maxSize + size)
+			&& VirtualLock(const_cast<void*>(data), size)) {
+			return true;
+		}
+		VI_WARN("Unable to lock %zu bytes of memory.", size);
+		return false;
+	}
+
+	void unlockMemory(const void* data, size_t size) noexcept {
+		VirtualUnlock(const_cast<void*>(data), size);
+	}
+
+	void replaceFile(const fs::path& path, std::string_view data) {
+		fs::path temp = path;
+		temp += ".tmp";
+
+		const HANDLE file = CreateFileW(temp.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			throw IOError(std::format("Unable to create {} (error {}).", temp.string(), GetLastError()));
+		}
+		for (size_t written = 0; written < data.size();) {
+			const DWORD count = static_cast<DWORD>(std::min<size_t>(data.size() - written, MAXDWORD));
+			DWORD result = 0;
+			if (!WriteFile(file, data.data() + written, count, &result, nullptr)) {
+				const DWORD error = GetLastError();
+				CloseHandle(file);
+				DeleteFileW(temp.c_str());
+				throw IOError(std::format("Unable to write {} (error {}).", temp.string(), error));
+			}
+			written += result;
+		}
+		// Without this, the rename may reach the disk before the data does.
+		if (!FlushFileBuffers(file)) {
+			const DWORD error = GetLastError();
+			CloseHandle(file);
+			DeleteFileW(temp.c_str());
+			throw IOError(std::format("Unable to flush {} (error {}).", temp.string(), error));
+		}
+		CloseHandle(file);
+
+		if (!MoveFileExW(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+			const DWORD error = GetLastError();
+			DeleteFileW(temp.c_str());
+			throw IOError(std::format("Unable to replace {} (error {}).", path.string(), error));
+		}
+	}
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+project "ViBoardBench"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "On"
+	targetdir "bin/%{cfg.buildcfg}/%{cfg.architecture}"
+	objdir "bin/intermediates/%{cfg.buildcfg}/%{cfg.architecture}"
+
+	-- Everything below the UI and the OS. src/Platform.cpp stands in for the platform layer.
+	files {
+		"src/**.h",
+		"src/**.cpp",
+		"../ViBoard/src/Audio.h",
+		"../ViBoard/src/Audio.cpp",
+		"../ViBoard/src/AudioEngine.h",
+		"../ViBoard/src/AudioEngine.cpp",
+		"../ViBoard/src/Exceptions.cpp",
+		"../ViBoard/src/Hash.h",
+		"../ViBoard/src/Hash.cpp",
+		"../ViBoard/src/Histogram.h",
+		"../ViBoard/src/Mixer.h",
+		"../ViBoard/src/Mixer.cpp",
+		"../ViBoard/src/PcmArena.h",
+		"../ViBoard/src/PcmArena.cpp",
+		"../ViBoard/src/Settings.h",
+		"../ViBoard/src/Settings.cpp",
+		"../ViBoard/src/SettingsWriter.h",
+		"../ViBoard/src/SettingsWriter.cpp",
+		"../ViBoard/src/SoundLoader.h",
+		"../ViBoard/src/SoundLoader.cpp",
+		"../ViBoard/src/platform/Hotkey.h",
+		"../ViBoard/src/platform/Hotkey.cpp",
+		-- Only compiled in on Linux, where the hotkey suite feeds it fake key presses.
+		"../ViBoard/src/platform/HotkeyLinux.cpp",
+		"../ViBoard/src/platform/KeycodesLinux.h",
+		"../ViBoard/src/platform/KeycodesLinux.cpp"
+	}
+
+	includedirs {
+		"../ViBoard/src",
+		"../dependencies/SDL3/include",
+		"../dependencies/json/single_include",
+		"../dependencies/minimp3"
+	}
+
+	links {
+		"SDL3"
+	}
+
+	defines {
+		"VI_LOG_LEVEL=0",
+		"VI_EXECUTEABLE_NAME=\"ViBoard\""
+	}
+
+	filter "platforms:x64"
+		architecture "x86_64"
+	
+	filter "platforms:x86"
+		architecture "x86"
+
+	filter { "action:vs*", "platforms:x64" }
+		libdirs { "../dependencies/SDL3/vc/x64" }
+		postbuildcommands { "{COPYFILE} %[../dependencies/SDL3/vc/x64/SDL3.dll] %[%{cfg.targetdir}]" }
+
+	filter { "action:vs*", "platforms:x86" }
+		libdirs { "../dependencies/SDL3/vc/x86" }
+		postbuildcommands { "{COPYFILE} %[../dependencies/SDL3/vc/x86/SDL3.dll] %[%{cfg.targetdir}]" }
+
+	filter { "system:windows", "toolset:mingw or gcc", "platforms:x64" }
+		libdirs { "../dependencies/SDL3/mingw/x64/lib" }
+
+	filter { "system:windows", "toolset:mingw or gcc", "platforms:x86" }
+		libdirs { "../dependencies/SDL3/mingw/x86/lib" }
+
+	filter "system:windows"
+		systemversion "latest"
+		defines { "VI_PLATFORM_WINDOWS" }
+
+	filter "system:linux"
+		defines { "VI_PLATFORM_LINUX" }
+		links { "pthread" }
+
+	filter "configurations:Debug"
+		runtime "Debug"
+		symbols "On"
+
+	filter "configurations:Release"
+		runtime "Release"
+		optimize "On"
+		symbols "Off"
+
+	-- Release builds fail if playback got slower or any of its checks fail. Only where SDL3 can be loaded when it runs.
+	filter { "configurations:Release", "system:linux" }
+		postbuildmessage "Checking playback"
+		postbuildcommands { "%[%{cfg.buildtarget.abspath}] --only playback" }
+
+	filter { "configurations:Release", "action:vs*" }
+		postbuildmessage "Checking playback"
+		postbuildcommands { "%[%{cfg.buildtarget.abspath}] --only playback" }
+
+	filter "action:vs*"
+		defines { "VI_MSVC" }
\ No newline at end of file
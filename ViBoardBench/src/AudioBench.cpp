@@ -0,0 +1,110 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Bench.h"
+#include "Audio.h"
+#include "Mixer.h"
+
+#include <SDL3/SDL.h>
+
+#include <format>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	namespace {
+		constexpr int decodeRuns = 5;
+		constexpr uint32_t decodeFileCount = 10;
+		constexpr uint32_t decodeFileFrames = 44100 * 5;
+
+		// Seconds of audio handled per second of wall time.
+		double toRealtime(uint64_t frames, double milliseconds) {
+			return static_cast<double>(frames) / mixSpec.freq / (milliseconds / 1000);
+		}
+
+		void addDecodeResult(BenchReport& report, const std::vector<fs::path>& files, const char* format, bool useArena) {
+			uint64_t frames = 0;
+			const double time = measure([&]() {
+				// A fresh arena each run, and nothing kept, so no run gets its samples from the previous one.
+				const auto arena = useArena ? std::make_shared<PcmArena>() : nullptr;
+				frames = 0;
+				for (const fs::path& file : files) {
+					frames += decodeSound(file, nullptr, arena.get())->getFrames();
+				}
+			}, decodeRuns);
+			report.add({"decode", {{"format", format}, {"files", files.size()}, {"arena", useArena}}, time, toRealtime(frames, time), "x realtime"});
+		}
+	}
+
+	void runDecodeBenchmarks(BenchReport& report, const fs::path& scratchDir, const fs::path& soundsDir) {
+		const fs::path dir = scratchDir / "decode";
+		fs::create_directories(dir);
+		std::vector<fs::path> wavFiles;
+		for (uint32_t i = 0; i < decodeFileCount; i++) {
+			fs::path& path = wavFiles.emplace_back(dir / std::format("{}.wav", i));
+			std::ofstream(path, std::ios::binary) << makeWav(decodeFileFrames, i);
+		}
+		addDecodeResult(report, wavFiles, "wav", false);
+		addDecodeResult(report, wavFiles, "wav", true);
+
+		if (soundsDir.empty()) {
+			return;
+		}
+		std::map<std::string, std::vector<fs::path>> byFormat;
+		for (const fs::directory_entry& file : fs::directory_iterator(soundsDir)) {
+			const fs::path ext = file.path().extension();
+			if (file.is_regular_file() && isSupported(ext)) {
+				byFormat[ext.string().substr(1)].push_back(file.path());
+			}
+		}
+		for (const auto& [format, files] : byFormat) {
+			addDecodeResult(report, files, format.c_str(), true);
+		}
+	}
+
+	void runMixBenchmarks(BenchReport& report) {
+		constexpr int renderFrames = 48000 * 10;
+		constexpr uint32_t sourceFrames = 44100 * 12;
+
+		// Long enough that no voice finishes during the render.
+		const std::string wav = makeWav(sourceFrames, 0);
+		constexpr SDL_AudioSpec sourceSpec{SDL_AUDIO_S16, 2, 44100};
+		const auto samples = std::make_shared<const SampleBuffer>(sourceSpec, reinterpret_cast<const uint8_t*>(wav.data() + 44), static_cast<int>(wav.size() - 44));
+
+		const auto mixer = std::make_unique<Mixer>();
+		std::vector<float> out(Mixer::maxChunkFrames * mixSpec.channels);
+		constexpr size_t voiceCounts[] = {1, 4, 8, Mixer::maxVoices};
+		for (const size_t voices : voiceCounts) {
+			const double time = measure([&]() {
+				mixer->stop();
+				for (size_t i = 0; i < voices; i++) {
+					// Half the voices take the gain override path.
+					mixer->play(samples, {0.5f, i % 2 == 1});
+				}
+				for (int frames = 0; frames < renderFrames; frames += Mixer::maxChunkFrames) {
+					mixer->renderOffline(out.data(), Mixer::maxChunkFrames);
+				}
+			});
+			report.add({"mix", {{"voices", voices}}, time, toRealtime(renderFrames, time), "x realtime"});
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+namespace vi {
+	namespace {
+		std::string formatParams(const nlohmann::json& params) {
+			std::string string;
+			for (const auto& [key, value] : params.items()) {
+				if (!string.empty()) {
+					string += ' ';
+				}
+				string += key + '=' + (value.is_string() ? value.get<std::string>() : value.dump());
+			}
+			return string;
+		}
+
+		template<typename T>
+		void append(std::string& data, T value) {
+			char bytes[sizeof(T)];
+			memcpy(bytes, &value, sizeof(T));
+			data.append(bytes, sizeof(T));
+		}
+	}
+
+	void BenchReport::add(BenchResult result) {
+		printf("%-22s %-34s %10.2f ms", result.name.c_str(), formatParams(result.params).c_str(), result.milliseconds);
+		if (!result.unit.empty()) {
+			printf(" %12.1f %s", result.value, result.unit.c_str());
+		}
+		printf("\n");
+		fflush(stdout);
+		results.push_back(std::move(result));
+	}
+
+	nlohmann::json BenchReport::toJson() const {
+		nlohmann::json json;
+		json["version"] = 2;
+#ifdef NDEBUG
+		json["build"] = "release";
+#else
+		json["build"] = "debug";
+#endif
+		nlohmann::json& list = json["results"];
+		list = nlohmann::json::array();
+		for (const BenchResult& result : results) {
+			nlohmann::json& entry = list.emplace_back();
+			entry["name"] = result.name;
+			entry["params"] = result.params;
+			entry["ms"] = result.milliseconds;
+			if (!result.unit.empty()) {
+				entry["value"] = result.value;
+				entry["unit"] = result.unit;
+			}
+		}
+		return json;
+	}
+
+	double measure(const std::function<void()>& function, int runs) {
+		std::vector<double> times;
+		for (int i = 0; i < runs; i++) {
+			const auto start = std::chrono::steady_clock::now();
+			function();
+			const auto end = std::chrono::steady_clock::now();
+			times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+		}
+		std::sort(times.begin(), times.end());
+		return times[times.size() / 2];
+	}
+
+	std::string makeWav(uint32_t frames, uint32_t seed) {
+		constexpr uint16_t channels = 2;
+		constexpr uint32_t rate = 44100;
+		constexpr uint16_t frameSize = channels * sizeof(int16_t);
+		const uint32_t dataSize = frames * frameSize;
+
+		std::string data;
+		data.reserve(44 + dataSize);
+		data += "RIFF";
+		append<uint32_t>(data, 36 + dataSize);
+		data += "WAVEfmt ";
+		append<uint32_t>(data, 16);
+		append<uint16_t>(data, 1);
+		append<uint16_t>(data, channels);
+		append<uint32_t>(data, rate);
+		append<uint32_t>(data, rate * frameSize);
+		append<uint16_t>(data, frameSize);
+		append<uint16_t>(data, 16);
+		data += "data";
+		append<uint32_t>(data, dataSize);
+
+		// Quiet noise from a fixed LCG, so files stay the same between runs and commits.
+		uint32_t state = seed * 2654435761u + 1;
+		for (uint32_t i = 0; i < frames * channels; i++) {
+			state = state * 1664525u + 1013904223u;
+			append<int16_t>(data, static_cast<int16_t>((static_cast<int32_t>(state >> 16) - 32768) / 4));
+		}
+		return data;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace vi {
+	struct BenchResult {
+		// Dotted, such as "settings.load". Together with params, identifies the result across commits.
+		std::string name;
+		nlohmann::json params;
+		// Median of all runs.
+		double milliseconds = 0.0;
+		// A figure in the given unit, such as a throughput or a latency. Left out if there is no unit.
+		double value = 0.0;
+		std::string unit;
+	};
+
+	class BenchReport {
+	public:
+		// Prints the result as it comes in, so long suites show progress.
+		void add(BenchResult result);
+		nlohmann::json toJson() const;
+
+	private:
+		std::vector<BenchResult> results;
+	};
+
+	// Median of several runs, in milliseconds.
+	double measure(const std::function<void()>& function, int runs = 7);
+
+	// A 16-bit stereo 44.1 kHz WAV file of noise. The same seed always gives the same file,
+	// and different seeds give different ones, so they are not shared as duplicates.
+	std::string makeWav(uint32_t frames, uint32_t seed);
+
+	// Also checks that a synchronous save is never overwritten by an older queued one.
+	void runSettingsBenchmarks(BenchReport& report, const std::filesystem::path& scratchDir);
+	// Decodes generated WAV files, and every file in soundsDir if it is not empty.
+	void runDecodeBenchmarks(BenchReport& report, const std::filesystem::path& scratchDir, const std::filesystem::path& soundsDir);
+	void runMixBenchmarks(BenchReport& report);
+	void runLoaderBenchmarks(BenchReport& report, const std::filesystem::path& scratchDir);
+	// Checks that the mixer's output is sample accurate, both offline and as written by SDL's disk audio driver,
+	// then measures trigger latency on the dummy driver.
+	// Throws if any check fails, or if the median latency is above maxLatencyFrames, unless that is 0.
+	void runPlaybackBenchmarks(BenchReport& report, const std::filesystem::path& scratchDir, uint32_t maxLatencyFrames);
+	// Measures how long a key press written to a fake input device takes to reach its hotkey callback.
+	// Does nothing on Windows.
+	void runHotkeyBenchmarks(BenchReport& report);
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Bench.h"
+#include "platform/Hotkey.h"
+
+#include <SDL3/SDL.h>
+
+#ifdef VI_PLATFORM_LINUX
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <semaphore>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+#include <unistd.h>
+#include <linux/input.h>
+#endif
+
+namespace vi {
+#ifdef VI_PLATFORM_LINUX
+	namespace {
+		constexpr int pressCount = 101;
+		constexpr auto fireTimeout = std::chrono::seconds(5);
+
+		struct HotkeyThread {
+			HotkeyThread() {
+				initHotkeys();
+			}
+
+			~HotkeyThread() {
+				quitHotkeys();
+			}
+		};
+
+		// Timestamped like a real device with EVIOCSCLOCKID set to CLOCK_MONOTONIC.
+		input_event makeEvent(uint16_t type, uint16_t code, int32_t value) {
+			timespec now;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			input_event event{};
+			event.time.tv_sec = now.tv_sec;
+			event.time.tv_usec = now.tv_nsec / 1000;
+			event.type = type;
+			event.code = code;
+			event.value = value;
+			return event;
+		}
+
+		// A press and release of key, as a keyboard reports them.
+		std::array<input_event, 4> makeKeyStroke(uint16_t key) {
+			return {
+				makeEvent(EV_KEY, key, 1),
+				makeEvent(EV_SYN, SYN_REPORT, 0),
+				makeEvent(EV_KEY, key, 0),
+				makeEvent(EV_SYN, SYN_REPORT, 0)
+			};
+		}
+
+		void writeAll(int fd, const char* data, size_t size) {
+			while (size > 0) {
+				const ssize_t written = write(fd, data, size);
+				if (written < 0) {
+					throw std::runtime_error("Unable to write to the fake hotkey input.");
+				}
+				data += written;
+				size -= static_cast<size_t>(written);
+			}
+		}
+
+		// Median time from writing a key stroke to its callback running, in milliseconds. With split, each stroke
+		// is written in two parts with a pause between, so the hotkey thread sees an event cut in half.
+		double measureDispatch(int input, std::binary_semaphore& fired, const std::atomic<Uint64>& firedTime, bool split) {
+			std::vector<Uint64> times;
+			for (int i = 0; i < pressCount; i++) {
+				const auto stroke = makeKeyStroke(KEY_F24);
+				const char* data = reinterpret_cast<const char*>(stroke.data());
+				size_t size = sizeof(stroke);
+				if (split) {
+					const size_t half = sizeof(input_event) / 2;
+					writeAll(input, data, half);
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					data += half;
+					size -= half;
+				}
+
+				const Uint64 start = SDL_GetTicksNS();
+				writeAll(input, data, size);
+				if (!fired.try_acquire_for(fireTimeout)) {
+					throw std::runtime_error("Hotkey did not fire from the fake input.");
+				}
+				times.push_back(firedTime.load() - start);
+			}
+			std::sort(times.begin(), times.end());
+			return static_cast<double>(times[times.size() / 2]) / 1'000'000;
+		}
+	}
+
+	void runHotkeyBenchmarks(BenchReport& report) {
+		HotkeyThread thread;
+
+		const int input = openFakeHotkeyInput();
+		if (input < 0) {
+			throw std::runtime_error("Unable to open a fake hotkey input.");
+		}
+
+		std::binary_semaphore fired{0};
+		std::atomic<Uint64> firedTime = 0;
+		Hotkey hotkey;
+		hotkey.scancode = SDL_SCANCODE_F24;
+		hotkey.raw = KEY_F24;
+		hotkey.callback = [&fired, &firedTime]() {
+			firedTime = SDL_GetTicksNS();
+			fired.release();
+		};
+		const HotkeyId id = registerHotkey(hotkey);
+		if (id == nullHotkey) {
+			close(input);
+			throw std::runtime_error("Unable to register the bench hotkey.");
+		}
+
+		try {
+			for (const bool split : {false, true}) {
+				const double time = measureDispatch(input, fired, firedTime, split);
+				report.add({"hotkey.dispatch", {{"source", "pipe"}, {"split", split}}, time, time * 1000, "us"});
+			}
+		} catch (...) {
+			unregisterHotkey(id);
+			close(input);
+			throw;
+		}
+
+		unregisterHotkey(id);
+		flushHotkeys();
+		close(input);
+	}
+#else
+	// Windows hotkeys go through RegisterHotKey, which cannot be fed fake key presses.
+	void runHotkeyBenchmarks(BenchReport& report) {
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Bench.h"
+#include "SoundLoader.h"
+
+#include <SDL3/SDL.h>
+
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	namespace {
+		constexpr int loadRuns = 3;
+		// Short clips, so the larger boards measure per-file overhead rather than just decoding.
+		constexpr uint32_t clipFrames = 44100 / 20;
+
+		SoundLoader::Result waitForResult(SoundLoader& loader) {
+			SDL_Event event;
+			while (SDL_WaitEvent(&event)) {
+				if (event.type != getSoundLoadedEventType()) {
+					continue;
+				}
+				std::vector<SoundLoader::Result> results = loader.takeResults();
+				if (!results.empty()) {
+					return std::move(results.front());
+				}
+			}
+			throw std::runtime_error(SDL_GetError());
+		}
+	}
+
+	void runLoaderBenchmarks(BenchReport& report, const fs::path& scratchDir) {
+		SoundLoader loader;
+		for (const uint32_t count : {100, 1000, 10000}) {
+			const fs::path board = scratchDir / std::format("board{}", count);
+			fs::create_directories(board);
+			for (uint32_t i = 0; i < count; i++) {
+				std::ofstream(board / std::format("{}.wav", i), std::ios::binary) << makeWav(clipFrames, count + i);
+			}
+
+			// A new board: every file is decoded.
+			std::vector<Sound> sounds;
+			const double loadTime = measure([&]() {
+				sounds.clear();
+				loader.sync(board, std::make_shared<PcmArena>(), {});
+				sounds = std::move(waitForResult(loader).added);
+			}, loadRuns);
+			if (sounds.size() != count) {
+				throw std::runtime_error(std::format("Loaded {} of {} sounds.", sounds.size(), count));
+			}
+			report.add({"board.load", {{"files", count}}, loadTime, count / (loadTime / 1000), "files/s"});
+
+			// Refreshing a board nothing has changed on: only listing and diffing.
+			std::vector<const Sound*> manifest;
+			for (const Sound& sound : sounds) {
+				manifest.push_back(&sound);
+			}
+			const double refreshTime = measure([&]() {
+				loader.sync(board, nullptr, manifest);
+				const SoundLoader::Result result = waitForResult(loader);
+				if (!result.added.empty() || !result.removed.empty() || !result.updated.empty()) {
+					throw std::runtime_error("Refresh found changes on an unchanged board.");
+				}
+			});
+			report.add({"board.refresh", {{"files", count}}, refreshTime, count / (refreshTime / 1000), "files/s"});
+		}
+	}
+}
\ No newline at end of file
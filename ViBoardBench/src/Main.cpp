@@ -0,0 +1,128 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Bench.h"
+
+#include <SDL3/SDL.h>
+
+#include <nlohmann/json.hpp>
+
+#include <charconv>
+#include <exception>
+#include <stdexcept>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <stdio.h>
+
+namespace fs = std::filesystem;
+using namespace vi;
+
+namespace {
+	// Two device buffers at SDL's default size for 48 kHz. The dummy driver needs one.
+	constexpr uint32_t defaultMaxLatencyFrames = 2048;
+
+	void printUsage() {
+		printf(
+			"Usage: ViBoardBench [--only settings|decode|mix|loader|playback|hotkey] [--sounds <dir>] [--json <file>] [--max-latency <frames>]\n"
+			"  --only         Runs a single suite.\n"
+			"  --sounds       Also measures decoding every .mp3 and .wav file in the folder.\n"
+			"  --json         Writes the results to a file, for comparing across commits.\n"
+			"  --max-latency  Fails if playback latency, not counting the pre-roll, is over this many frames. %u by default, 0 for no limit.\n",
+			defaultMaxLatencyFrames
+		);
+	}
+}
+
+int main(int argc, char** argv) {
+	std::string only;
+	fs::path soundsDir;
+	fs::path jsonPath;
+	uint32_t maxLatencyFrames = defaultMaxLatencyFrames;
+	for (int i = 1; i < argc; i++) {
+		const std::string_view arg = argv[i];
+		if (i + 1 < argc && arg == "--only") {
+			only = argv[++i];
+		} else if (i + 1 < argc && arg == "--sounds") {
+			soundsDir = argv[++i];
+		} else if (i + 1 < argc && arg == "--json") {
+			jsonPath = argv[++i];
+		} else if (i + 1 < argc && arg == "--max-latency") {
+			const std::string_view value = argv[++i];
+			if (std::from_chars(value.data(), value.data() + value.size(), maxLatencyFrames).ec != std::errc()) {
+				printUsage();
+				return 1;
+			}
+		} else {
+			printUsage();
+			return 1;
+		}
+	}
+
+	// Only needed for the loader's, mixer's and hotkeys' events. The playback suite opens SDL's audio drivers itself.
+	if (!SDL_Init(SDL_INIT_EVENTS)) {
+		fprintf(stderr, "%s\n", SDL_GetError());
+		return 1;
+	}
+
+	const fs::path scratchDir = fs::temp_directory_path() / "ViBoardBench";
+	BenchReport report;
+	int status = 0;
+	try {
+		fs::remove_all(scratchDir);
+		fs::create_directories(scratchDir);
+
+		const auto runs = [&only](const char* suite) {
+			return only.empty() || only == suite;
+		};
+		if (runs("settings")) {
+			runSettingsBenchmarks(report, scratchDir);
+		}
+		if (runs("decode")) {
+			runDecodeBenchmarks(report, scratchDir, soundsDir);
+		}
+		if (runs("mix")) {
+			runMixBenchmarks(report);
+		}
+		if (runs("loader")) {
+			runLoaderBenchmarks(report, scratchDir);
+		}
+		if (runs("playback")) {
+			runPlaybackBenchmarks(report, scratchDir, maxLatencyFrames);
+		}
+		if (runs("hotkey")) {
+			runHotkeyBenchmarks(report);
+		}
+
+		if (!jsonPath.empty()) {
+			std::ofstream file(jsonPath);
+			file << report.toJson().dump(1, '\t');
+			if (!file) {
+				throw std::runtime_error("Unable to write " + jsonPath.string());
+			}
+		}
+	} catch (const std::exception& e) {
+		fprintf(stderr, "%s\n", e.what());
+		status = 1;
+	}
+
+	std::error_code error;
+	fs::remove_all(scratchDir, error);
+	SDL_Quit();
+	return status;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// The bench runs the engine without a window or event loop, and only registers hotkeys on Linux, through a fake input.
+// These stand in for the few platform hooks the engine code calls, in place of the OS-specific sources.
+
+#include "Exceptions.h"
+#include "platform/Hotkey.h"
+#include "platform/Platform.h"
+
+#include <format>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	size_t getPageSize() noexcept {
+		return 4096;
+	}
+
+	// Left unlocked, as the OS may cap how much can be and decoding speed should not depend on it.
+	bool lockMemory(const void* data, size_t size) noexcept {
+		return false;
+	}
+
+	void unlockMemory(const void* data, size_t size) noexcept {
+	}
+
+	void wakeUpEventLoop() noexcept {
+	}
+
+	// Still through a temporary file, but without syncing, so the settings writer's checks do not wait on the disk.
+	void replaceFile(const fs::path& path, std::string_view data) {
+		fs::path temp = path;
+		temp += ".tmp";
+		{
+			std::ofstream file(temp, std::ios::binary);
+			file.write(data.data(), static_cast<std::streamsize>(data.size()));
+			if (!file) {
+				throw IOError(std::format("Unable to write {}", temp.string()));
+			}
+		}
+		std::error_code error;
+		fs::rename(temp, path, error);
+		if (error) {
+			throw IOError(std::format("Unable to replace {}: {}", path.string(), error.message()));
+		}
+	}
+
+	// Push-to-talk timing is measured on the mixer, so the key never needs to reach the OS.
+	void sendKeyPress(SDL_Scancode scancode, uint16_t raw, bool pressed) noexcept {
+	}
+
+#ifndef VI_PLATFORM_LINUX
+	bool unregisterHotkey(HotkeyId id) noexcept {
+		return false;
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,382 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Bench.h"
+#include "AudioEngine.h"
+#include "Mixer.h"
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	namespace {
+		constexpr int channels = mixSpec.channels;
+		constexpr int triggerCount = 21;
+		constexpr uint32_t clipFrames = 44100 / 20;
+		constexpr uint32_t preRollMs = 50;
+		constexpr Sint32 eventTimeoutMs = 5000;
+		// Long enough to still be playing when the next sound cuts it off.
+		constexpr uint32_t longClipFrames = 44100 * 2;
+		// How far apart the two outputs may start on the disk driver, which mixes them into one file.
+		constexpr int64_t maxOutputSkew = 4096;
+
+		struct Latency {
+			double milliseconds = 0.0;
+			uint32_t frames = 0;
+		};
+
+		// Already in the mix format, so nothing is converted and every sample is exactly value.
+		std::shared_ptr<const SampleBuffer> makeConstant(float value, uint32_t frames) {
+			const std::vector<float> data(static_cast<size_t>(frames) * channels, value);
+			return std::make_shared<const SampleBuffer>(mixSpec, reinterpret_cast<const uint8_t*>(data.data()),
+				static_cast<int>(data.size() * sizeof(float)));
+		}
+
+		void expect(bool condition, const char* check) {
+			if (!condition) {
+				throw std::runtime_error(std::format("Playback check \"{}\" failed.", check));
+			}
+		}
+
+		// Renders the next frames and compares every sample with expected(frame), counting from the first of them.
+		void expectRender(Mixer& mixer, int frames, const std::function<float(int)>& expected, const char* check) {
+			std::array<float, Mixer::maxChunkFrames * channels> out;
+			for (int done = 0; done < frames;) {
+				const int count = std::min(frames - done, Mixer::maxChunkFrames);
+				mixer.renderOffline(out.data(), count);
+				for (int i = 0; i < count * channels; i++) {
+					const int frame = done + i / channels;
+					if (out[i] != expected(frame)) {
+						throw std::runtime_error(std::format("Playback check \"{}\" failed at frame {}: expected {}, got {}.",
+							check, frame, expected(frame), out[i]));
+					}
+				}
+				done += count;
+			}
+		}
+
+		// Lengths and delays are picked so that sounds start and end partway into a chunk.
+		int runOfflineChecks() {
+			const auto first = makeConstant(0.25f, 2000);
+			const auto second = makeConstant(0.125f, 1000);
+			const auto silence = [](int) {
+				return 0.0f;
+			};
+
+			Mixer sum;
+			sum.play(first, {});
+			sum.play(second, {});
+			expectRender(sum, 3000, [](int frame) {
+				return frame < 1000 ? 0.375f : frame < 2000 ? 0.25f : 0.0f;
+			}, "sum");
+
+			// Overrides replace the output's gain rather than scaling it.
+			Mixer gain;
+			gain.setGain(0.5f);
+			gain.play(first, {});
+			gain.play(second, {2.0f, true});
+			expectRender(gain, 2000, [](int frame) {
+				return frame < 1000 ? 0.375f : 0.125f;
+			}, "gain");
+
+			Mixer delay;
+			expectRender(delay, 300, silence, "idle");
+			delay.play(first, {}, 0, 1500);
+			expect(delay.getLatencyFrames() == 1500, "latency frames");
+			expectRender(delay, 4000, [](int frame) {
+				return frame >= 1500 && frame < 3500 ? 0.25f : 0.0f;
+			}, "delay");
+
+			Mixer stop;
+			stop.play(first, {});
+			expectRender(stop, 100, [](int) {
+				return 0.25f;
+			}, "before stop");
+			stop.stop();
+			expectRender(stop, 100, silence, "stop");
+
+			Mixer replace;
+			replace.play(first, {});
+			expectRender(replace, 100, [](int) {
+				return 0.25f;
+			}, "before replace");
+			replace.replace(second, {});
+			expectRender(replace, 1500, [](int frame) {
+				return frame < 1000 ? 0.125f : 0.0f;
+			}, "replace");
+
+			// The tail is counted from the chunk the last voice ended in.
+			Mixer tail;
+			tail.setTail(1500);
+			tail.play(second, {});
+			expectRender(tail, Mixer::maxChunkFrames, [](int frame) {
+				return frame < 1000 ? 0.125f : 0.0f;
+			}, "before tail");
+			expect(tail.isPlaying(), "tail started");
+			expectRender(tail, Mixer::maxChunkFrames, silence, "tail");
+			expect(tail.isPlaying(), "tail held");
+			expectRender(tail, Mixer::maxChunkFrames, silence, "tail");
+			expect(!tail.isPlaying(), "tail ended");
+			return 6;
+		}
+
+		// Sample i of a capture that has clip in it from frame start on, and silence everywhere else.
+		float clipSample(const SampleBuffer& clip, int64_t start, size_t i) noexcept {
+			const int64_t frame = static_cast<int64_t>(i / channels) - start;
+			if (frame < 0 || frame >= static_cast<int64_t>(clip.getFrames())) {
+				return 0.0f;
+			}
+			return clip.getData()[static_cast<size_t>(frame) * channels + i % channels];
+		}
+
+		int64_t countFrames(const std::vector<float>& captured) noexcept {
+			return static_cast<int64_t>(captured.size() / channels);
+		}
+
+		// The first frame that is not silent, or frames if all of them are.
+		int64_t firstSound(const float* data, size_t frames) noexcept {
+			const float* found = std::find_if(data, data + frames * channels, [](float sample) {
+				return sample != 0.0f;
+			});
+			return static_cast<int64_t>(found - data) / channels;
+		}
+
+		// Where clip starts in captured, going by their first sounds. Leading silence is whatever the device
+		// wrote before the sound was played, so its length varies from run to run.
+		int64_t findClip(const std::vector<float>& captured, const SampleBuffer& clip, const char* check) {
+			const int64_t first = firstSound(captured.data(), captured.size() / channels);
+			if (first == countFrames(captured)) {
+				throw std::runtime_error(std::format("Playback check \"{}\" failed: nothing was captured.", check));
+			}
+			return first - firstSound(clip.getData(), clip.getFrames());
+		}
+
+		// Index of the first sample that differs from expected(i), or captured.size() if none does.
+		size_t findMismatch(const std::vector<float>& captured, const std::function<float(size_t)>& expected) {
+			for (size_t i = 0; i < captured.size(); i++) {
+				if (captured[i] != expected(i)) {
+					return i;
+				}
+			}
+			return captured.size();
+		}
+
+		void expectCapture(const std::vector<float>& captured, const std::function<float(size_t)>& expected, const char* check) {
+			const size_t i = findMismatch(captured, expected);
+			if (i != captured.size()) {
+				throw std::runtime_error(std::format("Playback check \"{}\" failed at frame {}: expected {}, got {}.",
+					check, i / channels, expected(i), captured[i]));
+			}
+		}
+
+		// Runs play on a new engine with SDL's disk driver writing to path, and returns everything that was written.
+		// The file is only complete once the last output has closed, which destroying the engine does.
+		std::vector<float> capture(const fs::path& path, const std::function<void(AudioEngine&)>& play) {
+			SDL_SetHint(SDL_HINT_AUDIO_DISK_OUTPUT_FILE, path.string().c_str());
+			{
+				AudioEngine engine;
+				play(engine);
+				// The file has no header, so it has to be in the mix format to be read back as is.
+				SDL_AudioSpec spec;
+				expect(SDL_GetAudioDeviceFormat(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, nullptr)
+					&& spec.format == mixSpec.format && spec.channels == mixSpec.channels && spec.freq == mixSpec.freq, "disk format");
+			}
+
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			std::vector<float> captured(static_cast<size_t>(file.tellg()) / sizeof(float) / channels * channels);
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(captured.data()), static_cast<std::streamsize>(captured.size() * sizeof(float)));
+			expect(file.good(), "disk read");
+			return captured;
+		}
+
+		// Handles playback events until the engine has gone quiet, as the app's event loop would.
+		void waitUntilFinished(AudioEngine& engine) {
+			SDL_Event event;
+			while (true) {
+				if (!SDL_WaitEventTimeout(&event, eventTimeoutMs)) {
+					throw std::runtime_error("Playback did not finish on the dummy audio driver.");
+				}
+				if (event.type != getPlaybackEventType()) {
+					continue;
+				}
+				engine.onPlaybackFinished();
+				if (!engine.isPlaying()) {
+					return;
+				}
+			}
+		}
+
+		// Medians over several triggers. Each waits for the last to finish, so none is queued behind another.
+		Latency measureLatency(AudioEngine& engine, LazySamples& samples) {
+			std::vector<Uint64> times;
+			std::vector<uint32_t> frames;
+			for (int i = 0; i < triggerCount; i++) {
+				engine.play(samples, {}, SDL_GetTicksNS());
+				waitUntilFinished(engine);
+				times.push_back(engine.getLatency());
+				frames.push_back(engine.getLatencyFrames());
+			}
+			std::sort(times.begin(), times.end());
+			std::sort(frames.begin(), frames.end());
+			return {static_cast<double>(times[times.size() / 2]) / 1'000'000, frames[frames.size() / 2]};
+		}
+
+		// Plays sounds through SDL's disk driver and compares what reached the file with the decoded samples, frame by
+		// frame. Gains are powers of two, so scaling and summing them is exact and nothing gets near clipping.
+		int runCaptureChecks(const fs::path& scratchDir, LazySamples& samples, LazySamples& longSamples) {
+			const SampleBuffer& clip = *samples.get();
+			const SampleBuffer& longClip = *longSamples.get();
+			const auto scaled = [](const SampleBuffer& buffer, int64_t start, float gain) {
+				return [&buffer, start, gain](size_t i) {
+					return clipSample(buffer, start, i) * gain;
+				};
+			};
+
+			const std::vector<float> single = capture(scratchDir / "single.raw", [&samples](AudioEngine& engine) {
+				engine.setOutput(0, SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, 0.5f);
+				engine.play(samples, {});
+				waitUntilFinished(engine);
+			});
+			const int64_t start = findClip(single, clip, "single output");
+			expect(start >= 0 && countFrames(single) >= start + clip.getFrames(), "single output length");
+			expectCapture(single, scaled(clip, start, 0.5f), "single output");
+
+			// Both outputs are on the one device, so the file has their sum. Each starts when its own stream is
+			// first pulled from, so the second may be a few device buffers behind or ahead of the first.
+			int count = 0;
+			SDL_AudioDeviceID* devices = SDL_GetAudioPlaybackDevices(&count);
+			const SDL_AudioDeviceID device = devices && count > 0 ? devices[0] : 0;
+			SDL_free(devices);
+			const std::vector<float> dual = capture(scratchDir / "dual.raw", [&samples, device](AudioEngine& engine) {
+				engine.setOutput(0, SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, 0.5f);
+				engine.setOutput(1, device, 0.25f);
+				engine.setDualPlayback(true);
+				engine.play(samples, {});
+				waitUntilFinished(engine);
+			});
+			const int64_t first = findClip(dual, clip, "dual output");
+			bool matched = false;
+			for (int64_t skew = -maxOutputSkew; skew <= maxOutputSkew && !matched; skew++) {
+				const int64_t primary = skew >= 0 ? first : first - skew;
+				const int64_t secondary = primary + skew;
+				matched = countFrames(dual) >= std::max(primary, secondary) + clip.getFrames()
+					&& findMismatch(dual, [&](size_t i) {
+						return clipSample(clip, primary, i) * 0.5f + clipSample(clip, secondary, i) * 0.25f;
+					}) == dual.size();
+			}
+			expect(matched, "dual output");
+
+			// The first sound plays without push-to-talk, so the key is not down yet when the second one cuts it off.
+			// That one then starts after exactly the pre-roll, with nothing of the first left in between.
+			const std::vector<float> preRoll = capture(scratchDir / "preroll.raw", [&samples, &longSamples](AudioEngine& engine) {
+				engine.setOutput(0, SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, 0.5f);
+				engine.setPushToTalkKey(SDL_SCANCODE_F13, 0);
+				engine.setPushToTalkTiming(preRollMs, 0);
+				engine.play(longSamples, {});
+				SDL_Delay(100);
+				expect(engine.isPlaying(), "pre-roll cut");
+				engine.setPushToTalkEnabled(true);
+				engine.play(samples, {});
+				waitUntilFinished(engine);
+			});
+			const int64_t longStart = findClip(preRoll, longClip, "pre-roll");
+			expect(longStart >= 0, "pre-roll");
+			const int64_t cut = static_cast<int64_t>(findMismatch(preRoll, scaled(longClip, longStart, 0.5f)) / channels);
+			expect(cut > longStart && cut < longStart + longClip.getFrames(), "pre-roll cut");
+			const int64_t clipStart = cut + preRollMs * mixSpec.freq / 1000;
+			expect(countFrames(preRoll) >= clipStart + clip.getFrames(), "pre-roll length");
+			expectCapture(preRoll, [&](size_t i) {
+				return static_cast<int64_t>(i / channels) < cut ? clipSample(longClip, longStart, i) * 0.5f
+					: clipSample(clip, clipStart, i) * 0.5f;
+			}, "pre-roll");
+			return 3;
+		}
+	}
+
+	void runPlaybackBenchmarks(BenchReport& report, const fs::path& scratchDir, uint32_t maxLatencyFrames) {
+		int checks = 0;
+		const double time = measure([&checks]() {
+			checks = runOfflineChecks();
+		}, 1);
+		report.add({"playback.offline", {{"checks", checks}}, time});
+
+		const fs::path path = scratchDir / "playback.wav";
+		std::ofstream(path, std::ios::binary) << makeWav(clipFrames, 0);
+		LazySamples samples(path);
+		samples.load();
+
+		const fs::path longPath = scratchDir / "playback-long.wav";
+		std::ofstream(longPath, std::ios::binary) << makeWav(longClipFrames, 1);
+		LazySamples longSamples(longPath);
+		longSamples.load();
+
+		SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "disk");
+		if (!SDL_InitSubSystem(SDL_INIT_AUDIO)) {
+			throw std::runtime_error(SDL_GetError());
+		}
+		const double captureTime = measure([&]() {
+			checks = runCaptureChecks(scratchDir, samples, longSamples);
+		}, 1);
+		report.add({"playback.capture", {{"driver", "disk"}, {"checks", checks}}, captureTime});
+		SDL_QuitSubSystem(SDL_INIT_AUDIO);
+
+		// The dummy driver pulls audio on a timer like real hardware would, without needing any or writing files.
+		SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+		if (!SDL_InitSubSystem(SDL_INIT_AUDIO)) {
+			throw std::runtime_error(SDL_GetError());
+		}
+
+		// The second output opens the device by its own ID rather than as the default, so both outputs are mixed.
+		int count = 0;
+		SDL_AudioDeviceID* devices = SDL_GetAudioPlaybackDevices(&count);
+		const SDL_AudioDeviceID device = devices && count > 0 ? devices[0] : 0;
+		SDL_free(devices);
+
+		AudioEngine engine;
+		engine.setOutput(0, SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, 1.0f);
+		engine.setOutput(1, device, 1.0f);
+		engine.setDualPlayback(true);
+		// The key is never actually sent, as the platform layer is stubbed out.
+		engine.setPushToTalkKey(SDL_SCANCODE_F13, 0);
+
+		for (const uint32_t preRoll : {0u, preRollMs}) {
+			engine.setPushToTalkEnabled(preRoll != 0);
+			engine.setPushToTalkTiming(preRoll, 0);
+			const Latency latency = measureLatency(engine, samples);
+			report.add({"playback.latency", {{"driver", "dummy"}, {"preroll", preRoll}}, latency.milliseconds, static_cast<double>(latency.frames), "frames"});
+
+			// The pre-roll is asked for, so only what comes on top of it counts against the limit.
+			const uint32_t preRollFrames = preRoll * mixSpec.freq / 1000;
+			const uint32_t extra = latency.frames > preRollFrames ? latency.frames - preRollFrames : 0;
+			if (maxLatencyFrames != 0 && extra > maxLatencyFrames) {
+				throw std::runtime_error(std::format("Playback latency is {} frames, over the limit of {}.", extra, maxLatencyFrames));
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+/*
+	ViBoard - Lightweight free & open-source soundboard.
+	Copyright (C) 2025-EndOfTime  goodguyartem <https://www.github.com/goodguyartem>
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Bench.h"
+#include "Settings.h"
+#include "SettingsWriter.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace vi {
+	namespace {
+		constexpr size_t soundsPerBoard = 500;
+		constexpr int writerRaces = 200;
+
+		Settings makeSettings(size_t soundCount) {
+			Settings settings;
+			settings.showWelcome = false;
+			for (size_t i = 0; i < soundCount; i++) {
+				if (i % soundsPerBoard == 0) {
+					settings.soundboards.emplace_back().path = std::format("/home/user/Soundboards/Board {}", i / soundsPerBoard);
+				}
+				SoundboardSettings& board = settings.soundboards.back();
+				SoundSettings& sound = board.sounds.emplace_back();
+				sound.path = board.path / std::format("Sound effect number {}.mp3", i);
+				sound.gains[0] = {0.5f + static_cast<float>(i % 100) / 100.0f, i % 3 == 0};
+				// A typical manifest entry for a few seconds of 44.1 kHz stereo.
+				sound.info = {60000 + i * 37, 133700000000000000 + static_cast<int64_t>(i) * 1000, 48000 * 3, 2, 44100, 0x9e3779b97f4a7c15ull * (i + 1)};
+				if (i % 10 == 0) {
+					sound.hotkey = HotkeyBinding{static_cast<SDL_Scancode>(SDL_SCANCODE_A + i % 26), static_cast<uint16_t>(30 + i % 26), SDL_KMOD_LCTRL};
+				}
+			}
+			settings.playback[0].preferred = "Speakers";
+			settings.playback[1].preferred = "CABLE Input";
+			return settings;
+		}
+
+		double toMegabytesPerSecond(size_t bytes, double milliseconds) {
+			return static_cast<double>(bytes) / (1024 * 1024) / (milliseconds / 1000);
+		}
+
+		// A save on exit waits for the file behind another save, and a snapshot is queued meanwhile. The exit save
+		// serializes once it gets the file, so it is the newer one and has to be what is left every time.
+		int runWriterChecks(const fs::path& scratchDir) {
+			const fs::path path = scratchDir / "settings.json";
+			const fs::path otherPath = scratchDir / "other.json";
+			for (int i = 0; i < writerRaces; i++) {
+				{
+					SettingsWriter writer;
+					std::atomic<bool> holding = false;
+					std::thread other([&writer, &otherPath, &holding]() {
+						writer.writeNow(otherPath, [&holding]() {
+							holding = true;
+							std::this_thread::sleep_for(std::chrono::milliseconds(3));
+							return std::string("other");
+						});
+					});
+					while (!holding) {
+						std::this_thread::yield();
+					}
+					std::thread exit([&writer, &path]() {
+						writer.writeNow(path, []() {
+							return std::string("exit");
+						});
+					});
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					writer.write(path, []() {
+						return std::string("queued");
+					});
+					other.join();
+					exit.join();
+				}
+				std::ifstream file(path, std::ios::binary);
+				const std::string contents{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+				if (contents != "exit") {
+					throw std::runtime_error(std::format("Settings writer check failed on run {}: found \"{}\" instead of the exit save.", i, contents));
+				}
+			}
+			return writerRaces;
+		}
+
+		// Paths outside ASCII have to come back exactly as they went in, in both formats.
+		int runPathChecks() {
+			Settings settings;
+			SoundboardSettings& board = settings.soundboards.emplace_back();
+			board.path = fs::path(u8"/home/user/Soundboards/Überraschung 効果音");
+			board.sounds.emplace_back().path = board.path / fs::path(u8"café ☕.mp3");
+
+			int checks = 0;
+			for (const SettingsFormat format : {SettingsFormat::Json, SettingsFormat::MessagePack}) {
+				const Settings result = parseSettings(serializeSettings(settings, format), format);
+				if (result.soundboards.size() != 1 || result.soundboards[0].path != board.path
+					|| result.soundboards[0].sounds.size() != 1 || result.soundboards[0].sounds[0].path != board.sounds[0].path) {
+					throw std::runtime_error("Settings check \"non-ASCII paths\" failed.");
+				}
+				checks++;
+			}
+			return checks;
+		}
+	}
+
+	void runSettingsBenchmarks(BenchReport& report, const fs::path& scratchDir) {
+		int checks = 0;
+		const double pathTime = measure([&checks]() {
+			checks = runPathChecks();
+		}, 1);
+		report.add({"settings.paths", {{"checks", checks}}, pathTime});
+
+		int races = 0;
+		const double writerTime = measure([&]() {
+			races = runWriterChecks(scratchDir);
+		}, 1);
+		report.add({"settings.writer", {{"races", races}}, writerTime});
+
+		for (const size_t count : {1000, 10000, 100000}) {
+			const Settings settings = makeSettings(count);
+
+			for (const SettingsFormat format : {SettingsFormat::Json, SettingsFormat::MessagePack}) {
+				const char* formatName = format == SettingsFormat::Json ? "json" : "msgpack";
+
+				std::string data;
+				const double writeTime = measure([&]() {
+					data = serializeSettings(settings, format);
+				});
+				report.add({"settings.write", {{"sounds", count}, {"format", formatName}}, writeTime, toMegabytesPerSecond(data.size(), writeTime), "MB/s"});
+
+				size_t loaded = 0;
+				const double loadTime = measure([&]() {
+					const Settings result = parseSettings(data, format);
+					loaded = 0;
+					for (const SoundboardSettings& board : result.soundboards) {
+						loaded += board.sounds.size();
+					}
+				});
+				if (loaded != count) {
+					throw std::runtime_error(std::format("Loaded {} of {} sounds.", loaded, count));
+				}
+				report.add({"settings.load", {{"sounds", count}, {"format", formatName}}, loadTime, toMegabytesPerSecond(data.size(), loadTime), "MB/s"});
+
+				if (format == SettingsFormat::Json) {
+					// What loading cost before: a full DOM parse, before any of it is read back.
+					const double domTime = measure([&]() {
+						const nlohmann::json document = nlohmann::json::parse(data);
+						loaded = document.at("soundboards").size();
+					});
+					report.add({"settings.load", {{"sounds", count}, {"format", "json-dom"}}, domTime, toMegabytesPerSecond(data.size(), domTime), "MB/s"});
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
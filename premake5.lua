@@ -4,5 +4,6 @@ workspace "ViBoard"
    startproject "ViBoard"
    
 include "ViBoard"
+include "ViBoardBench"
 group "dependencies"
    include "dependencies/imgui"
\ No newline at end of file